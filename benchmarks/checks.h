@@ -0,0 +1,497 @@
+//
+// Created by ludaludaed on 18.10.2026.
+//
+
+#ifndef ATOMIC_SHARED_POINTER_CHECKS_H
+#define ATOMIC_SHARED_POINTER_CHECKS_H
+
+#include "../src/decl_fwd.h"
+#include "../structures/lock_free_queue.h"
+#include "../structures/lock_free_set.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Targeted checks of states the stress tests rarely reach. They run before the benchmarks and fail by assert.
+
+struct Tracked {
+    explicit Tracked(std::atomic<int> *destroyed) : destroyed(destroyed) {}
+
+    ~Tracked() {
+        alive = false;
+        destroyed->fetch_add(1);
+    }
+
+    std::atomic<int> *destroyed;
+    bool alive{true};
+};
+
+void waitForStage(const std::atomic<int> &stage, int expected) {
+    while (stage.load() != expected) {
+        std::this_thread::yield();
+    }
+}
+
+// the last release on another thread destroys an object at once unless its owner opted in to biased counting
+void crossThreadReleaseCheck() {
+    constexpr int kObjects = 1000;
+    std::atomic<int> destroyed{0};
+    std::vector<lu::SharedPtr<Tracked>> handed_off;
+    std::thread owner([&] {
+        for (int i = 0; i < kObjects; ++i) {
+            handed_off.push_back(lu::makeShared<Tracked>(&destroyed));
+        }
+    });
+    owner.join();
+    std::thread consumer([&] {
+        handed_off.clear();
+    });
+    consumer.join();
+    assert(destroyed == kObjects);
+}
+
+// biased objects released by another thread are queued on their idle owner and destroyed after its next allocation
+void biasedCrossThreadReleaseCheck() {
+    constexpr int kObjects = 1000;
+    std::atomic<int> destroyed{0};
+    std::atomic<int> stage{0};
+    std::vector<lu::SharedPtr<Tracked>> handed_off;
+    std::thread owner([&] {
+        for (int i = 0; i < kObjects; ++i) {
+            handed_off.push_back(lu::makeShared<Tracked>(lu::kBiasedCount, &destroyed));
+        }
+        stage = 1;
+        waitForStage(stage, 2);
+        auto last = lu::makeShared<Tracked>(&destroyed);
+        stage = 3;
+        waitForStage(stage, 4);
+    });
+    waitForStage(stage, 1);
+    std::thread consumer([&] {
+        handed_off.clear();
+    });
+    consumer.join();
+    assert(destroyed == 0);
+    stage = 2;
+    waitForStage(stage, 3);
+    // the allocation merged the counters but left the destruction to the next release
+    lu::makeShared<int>(0);
+    assert(destroyed == kObjects);
+    stage = 4;
+    owner.join();
+    assert(destroyed == kObjects + 1);
+}
+
+// once another thread releases the last strong reference, no weak pointer brings the object back, also not while
+// the release waits for its idle owner
+void queuedWeakLockCheck() {
+    std::atomic<int> destroyed{0};
+    std::atomic<int> stage{0};
+    lu::SharedPtr<Tracked> object;
+    lu::WeakPtr<Tracked> weak;
+    std::thread owner([&] {
+        object = lu::makeShared<Tracked>(lu::kBiasedCount, &destroyed);
+        weak = object;
+        stage = 1;
+        waitForStage(stage, 2);
+        assert(weak.expired());
+        assert(!weak.lock());
+        lu::makeShared<int>(0);
+    });
+    waitForStage(stage, 1);
+    std::thread releaser([&] {
+        object.reset();
+    });
+    releaser.join();
+    assert(weak.expired());
+    assert(weak.useCount() == 0);
+    assert(!weak.lock());
+    stage = 2;
+    owner.join();
+    lu::makeShared<int>(0).reset();
+    assert(destroyed == 1);
+    assert(!weak.lock());
+}
+
+struct TrackedNode {
+    explicit TrackedNode(std::atomic<int> *destroyed) : destroyed(destroyed) {}
+
+    ~TrackedNode() {
+        destroyed->fetch_add(1);
+    }
+
+    std::atomic<int> *destroyed;
+    lu::SharedPtr<TrackedNode> next;
+};
+
+// objects left over by a destruction budget wait for releases or an explicit drain, allocations leave them alone
+void destructionBudgetCheck() {
+    constexpr int kLength = 100;
+    std::atomic<int> destroyed{0};
+    lu::SharedPtr<TrackedNode> head;
+    for (int i = 0; i < kLength; ++i) {
+        auto node = lu::makeShared<TrackedNode>(&destroyed);
+        node->next = std::move(head);
+        head = std::move(node);
+    }
+    lu::setDestructionBudget(1);
+    head.reset();
+    assert(destroyed == 1);
+    auto unrelated = lu::makeShared<int>(0);
+    assert(destroyed == 1);
+    unrelated.reset();
+    lu::setDestructionBudget(SIZE_MAX);
+    assert(lu::drainPendingDestruction() == kLength - 1);
+    assert(destroyed == kLength);
+}
+
+struct Pair {
+    int first;
+    int second;
+};
+
+// a weak pointer to a member goes through the atomic with its own address and expires with the owner
+void aliasedWeakCheck() {
+    auto owner = lu::makeShared<Pair>(Pair{1, 2});
+    lu::SharedPtr<int> second(owner, &owner->second);
+    lu::AtomicWeakPtr<int> atomic;
+    atomic.store(lu::WeakPtr<int>(second));
+    lu::WeakPtr<int> loaded = atomic.load();
+    assert(loaded.lock().get() == &owner->second);
+    lu::WeakPtr<int> other(lu::SharedPtr<int>(owner, &owner->first));
+    assert(!atomic.compareExchange(other, lu::WeakPtr<int>()));
+    assert(other.lock().get() == &owner->second);
+    lu::WeakPtr<int> first(lu::SharedPtr<int>(owner, &owner->first));
+    assert(atomic.compareExchange(loaded, first));
+    assert(atomic.exchange(lu::WeakPtr<int>()).lock().get() == &owner->first);
+    atomic.store(lu::WeakPtr<int>(second));
+    second.reset();
+    owner.reset();
+    assert(atomic.load().expired());
+    assert(!atomic.load().lock());
+}
+
+// lock() and tryLoadStrong() skip the temporary weak pointer, the locked pointer still has the member's address
+void aliasedWeakLockCheck() {
+    auto owner = lu::makeShared<Pair>(Pair{1, 2});
+    lu::AtomicWeakPtr<int> atomic;
+    atomic.store(lu::WeakPtr<int>(lu::SharedPtr<int>(owner, &owner->second)));
+    assert(atomic.lock().get() == &owner->second);
+    lu::SharedPtr<int> locked;
+    assert(atomic.tryLoadStrong(locked));
+    assert(locked.get() == &owner->second);
+    locked.reset();
+    owner.reset();
+    assert(!atomic.lock());
+    assert(!atomic.tryLoadStrong(locked));
+}
+
+// a combined update of an empty target fails without running the mutator and leaves the target empty
+void emptyCombinedUpdateCheck() {
+    lu::AtomicSharedPtr<int> target;
+    lu::UpdateCombiner<int> combiner(target);
+    bool applied = false;
+    bool thrown = false;
+    try {
+        combiner.update([&](int &value) { applied = true; });
+    } catch (const std::logic_error &) {
+        thrown = true;
+    }
+    assert(thrown && !applied && !target.load());
+    target.store(lu::makeShared<int>(1));
+    combiner.update([](int &value) { ++value; });
+    assert(*target.load() == 2);
+}
+
+// moving a snapshot or a group view leaves the source empty, only the target keeps the protected value
+void movedSnapshotCheck() {
+    lu::AtomicSharedPtr<int> atomic;
+    atomic.store(lu::makeShared<int>(1));
+    auto snapshot = atomic.snapshot();
+    auto moved = std::move(snapshot);
+    assert(!snapshot && snapshot.get() == nullptr);
+    assert(moved && *moved == 1);
+    snapshot = std::move(moved);
+    assert(!moved && *snapshot == 1);
+    lu::AtomicSharedGroup<int, int> group;
+    group.store(lu::makeShared<int>(2), lu::makeShared<int>(3));
+    auto view = group.view();
+    auto moved_view = std::move(view);
+    assert(view.get<0>() == nullptr && view.get<1>() == nullptr);
+    assert(*moved_view.get<0>() == 2 && *moved_view.get<1>() == 3);
+}
+
+struct SelfShared : lu::EnableSharedFromThis<SelfShared> {
+    int value{7};
+};
+
+// an object made by makeLocalShared hands out shared pointers to itself like one made by makeShared
+void localSharedFromThisCheck() {
+    auto local = lu::makeLocalShared<SelfShared>();
+    lu::SharedPtr<SelfShared> shared = local->sharedFromThis();
+    assert(shared.get() == local.get() && shared->value == 7);
+    assert(local.useCount() == 2);
+    shared.reset();
+    assert(!local->weakFromThis().expired());
+}
+
+// an aliased pointer stored in the atomic compares equal to itself by owner and address, also in wait()
+template <class Reclaimer>
+void aliasedStrongCheck() {
+    auto owner = lu::makeShared<Pair>(Pair{1, 2});
+    lu::SharedPtr<int> second(owner, &owner->second);
+    lu::SharedPtr<int> first(owner, &owner->first);
+    lu::AtomicSharedPtr<int, Reclaimer> atomic;
+    atomic.store(second);
+    lu::SharedPtr<int> expected = first;
+    assert(!atomic.compareExchange(expected, lu::SharedPtr<int>()));
+    assert(expected.get() == &owner->second);
+    atomic.wait(first);
+    expected = second;
+    assert(atomic.compareExchange(expected, first));
+    assert(atomic.load().get() == &owner->first);
+    std::thread storer([&] {
+        atomic.store(lu::makeShared<int>(3));
+        atomic.notifyAll();
+    });
+    atomic.wait(first);
+    storer.join();
+    assert(*atomic.load() == 3);
+}
+
+// notifyOne() wakes one parked waiter of the address at a time and none of another address
+void parkingLotCheck() {
+    std::atomic<int> value{0};
+    std::atomic<int> other{0};
+    std::atomic<int> checks{0};
+    std::atomic<int> woken{0};
+    auto park = [&](std::atomic<int> &word) {
+        lu::detail::ParkingLot::of(&word).waitUntil([&] {
+            checks.fetch_add(1);
+            return word.load() != 0;
+        });
+        woken.fetch_add(1);
+    };
+    std::vector<std::thread> waiters;
+    waiters.emplace_back(park, std::ref(value));
+    waiters.emplace_back(park, std::ref(value));
+    waiters.emplace_back(park, std::ref(other));
+    // a waiter checks once before and once after it parks
+    waitForStage(checks, 6);
+    value = 1;
+    lu::detail::ParkingLot::of(&value).notifyOne();
+    waitForStage(woken, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    assert(woken == 1 && checks == 7);
+    lu::detail::ParkingLot::of(&value).notifyAll();
+    waitForStage(woken, 2);
+    other = 1;
+    lu::detail::ParkingLot::of(&other).notifyOne();
+    for (auto &waiter: waiters) {
+        waiter.join();
+    }
+    assert(woken == 3);
+}
+
+// wait() returns once a store and a notification have happened, whichever thread parked first
+void atomicWaitCheck() {
+    auto initial = lu::makeShared<int>(1);
+    lu::AtomicSharedPtr<int> atomic;
+    atomic.store(initial);
+    std::thread waiter([&] {
+        atomic.wait(initial);
+        assert(*atomic.load() == 2);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    atomic.store(lu::makeShared<int>(2));
+    atomic.notifyOne();
+    waiter.join();
+    atomic.wait(initial);
+}
+
+// popFor() gives up on an empty queue, a push hands its value to a blocked popWait() or popFor()
+void queueWaitCheck() {
+    lu::LockFreeQueue<int> queue;
+    auto start = std::chrono::steady_clock::now();
+    assert(!queue.popFor(std::chrono::milliseconds(10)));
+    assert(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(10));
+    std::thread consumer([&] {
+        assert(queue.popWait() == 1);
+        assert(queue.popFor(std::chrono::seconds(10)) == 2);
+    });
+    queue.push(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    queue.push(2);
+    consumer.join();
+    queue.push(3);
+    assert(queue.popFor(std::chrono::milliseconds(0)) == 3);
+    assert(queue.empty());
+}
+
+// loads that hold on to more references than one batch has keep the count in range and the object alive
+void splitLoadBurstCheck() {
+    constexpr int kThreads = 8;
+    constexpr int kHeld = 20000;
+    std::atomic<int> destroyed{0};
+    lu::AtomicSharedPtr<Tracked, lu::SplitRefCount> atomic;
+    atomic.store(lu::makeShared<Tracked>(&destroyed));
+    std::vector<std::thread> loaders;
+    for (int i = 0; i < kThreads; ++i) {
+        loaders.emplace_back([&] {
+            std::vector<lu::SharedPtr<Tracked>> held;
+            for (int j = 0; j < kHeld; ++j) {
+                held.push_back(atomic.load());
+                assert(held.back()->alive);
+            }
+        });
+    }
+    for (auto &loader: loaders) {
+        loader.join();
+    }
+    assert(destroyed == 0 && atomic.load()->alive);
+    atomic.store(lu::SharedPtr<Tracked>());
+    assert(destroyed == 1);
+}
+
+// the mark travels with the pointer: load() returns the stored pointer untouched, a CAS has to expect the mark,
+// tryMark() only marks the expected unmarked pointer and keeps its reference
+void markableCheck() {
+    auto first = lu::makeShared<int>(1);
+    auto second = lu::makeShared<int>(2);
+    lu::MarkableAtomicSharedPtr<int> atomic;
+    atomic.store(first);
+    assert(!atomic.tryMark(second));
+    assert(atomic.tryMark(first));
+    assert(!atomic.tryMark(first));
+    assert(atomic.isMarked());
+    auto loaded = atomic.load();
+    assert(loaded.mark && loaded.ptr.get() == first.get() && *loaded.ptr == 1);
+    lu::MarkableAtomicSharedPtr<int>::Marked expected{first, false};
+    assert(!atomic.compareExchange(expected, second, false));
+    assert(expected.mark && expected.ptr.get() == first.get());
+    assert(atomic.compareExchange(expected, second, true));
+    loaded = atomic.load();
+    assert(loaded.mark && loaded.ptr.get() == second.get() && *loaded.ptr == 2);
+    atomic.store(lu::SharedPtr<int>());
+    assert(!atomic.isMarked() && !atomic.load().ptr);
+}
+
+// keys inserted and erased concurrently by threads on disjoint ranges end up as if each thread ran alone
+void lockFreeSetCheck() {
+    constexpr int kThreads = 4;
+    constexpr int kKeys = 1000;
+    lu::LockFreeSet<int> set;
+    std::vector<std::thread> workers;
+    for (int i = 0; i < kThreads; ++i) {
+        workers.emplace_back([&set, i] {
+            for (int key = i; key < kKeys; key += kThreads) {
+                assert(set.insert(key));
+                assert(!set.insert(key));
+            }
+            for (int key = i; key < kKeys; key += 2 * kThreads) {
+                assert(set.erase(key));
+                assert(!set.erase(key));
+            }
+        });
+    }
+    for (auto &worker: workers) {
+        worker.join();
+    }
+    for (int key = 0; key < kKeys; ++key) {
+        assert(set.contains(key) == (key % (2 * kThreads) >= kThreads));
+    }
+}
+
+template <class TValue>
+struct CountingAllocator {
+    using value_type = TValue;
+
+    explicit CountingAllocator(std::atomic<int> *live) : live(live) {}
+
+    template <class TOther>
+    CountingAllocator(const CountingAllocator<TOther> &other) : live(other.live) {}
+
+    TValue *allocate(size_t n) {
+        live->fetch_add(1);
+        return std::allocator<TValue>{}.allocate(n);
+    }
+
+    void deallocate(TValue *ptr, size_t n) {
+        live->fetch_sub(1);
+        std::allocator<TValue>{}.deallocate(ptr, n);
+    }
+
+    std::atomic<int> *live;
+};
+
+struct Large {
+    char bytes[8192];
+};
+
+// the split layout frees the value with the last strong reference, the default keeps one allocation of any size
+void splitLayoutCheck() {
+    std::atomic<int> live{0};
+    std::atomic<int> destroyed{0};
+    CountingAllocator<Tracked> allocator(&live);
+    auto split = lu::allocateShared<Tracked>(lu::kSplitLayout, allocator, &destroyed);
+    assert(live == 2);
+    lu::WeakPtr<Tracked> weak(split);
+    split.reset();
+    assert(destroyed == 1);
+    assert(live == 1);
+    weak.reset();
+    assert(live == 0);
+    auto inplace = lu::allocateShared<Tracked>(allocator, &destroyed);
+    weak = inplace;
+    inplace.reset();
+    assert(destroyed == 2);
+    assert(live == 1);
+    weak.reset();
+    assert(live == 0);
+    auto large = lu::allocateShared<Large>(CountingAllocator<Large>(&live));
+    assert(live == 1);
+    large.reset();
+    assert(live == 0);
+}
+
+// the isolated layout starts the value on a cache line of its own within the single allocation
+void isolatedLayoutCheck() {
+    std::atomic<int> live{0};
+    std::atomic<int> destroyed{0};
+    auto isolated = lu::allocateShared<Tracked>(lu::kIsolatedLayout, CountingAllocator<Tracked>(&live), &destroyed);
+    assert(live == 1);
+    assert(reinterpret_cast<uintptr_t>(isolated.get()) % lu::kCacheLineSize == 0);
+    assert(isolated->alive);
+    isolated.reset();
+    assert(destroyed == 1);
+    assert(live == 0);
+}
+
+void runChecks() {
+    crossThreadReleaseCheck();
+    biasedCrossThreadReleaseCheck();
+    queuedWeakLockCheck();
+    destructionBudgetCheck();
+    aliasedWeakCheck();
+    aliasedWeakLockCheck();
+    aliasedStrongCheck<lu::HazardPointers<lu::HPolicy<>>>();
+    aliasedStrongCheck<lu::SplitRefCount>();
+    splitLoadBurstCheck();
+    parkingLotCheck();
+    atomicWaitCheck();
+    queueWaitCheck();
+    markableCheck();
+    lockFreeSetCheck();
+    emptyCombinedUpdateCheck();
+    movedSnapshotCheck();
+    localSharedFromThisCheck();
+    splitLayoutCheck();
+    isolatedLayoutCheck();
+    std::cout << "checks passed" << std::endl;
+}
+
+#endif//ATOMIC_SHARED_POINTER_CHECKS_H
@@ -1,14 +1,49 @@
 #include "../src/decl_fwd.h"
+#include "../structures/bounded_queue.h"
+#include "../structures/elimination_stack.h"
 #include "../structures/lock_free_queue.h"
+#include "../structures/lock_free_set.h"
 #include "../structures/lock_free_stack.h"
+#include "../structures/segmented_queue.h"
+#include "checks.h"
 #include "std_atomic_sp.h"
 #include "vtyulb.h"
+#include <array>
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
+// bounded containers reject a push when full and are polled with tryPop()
+template <typename TContainer, typename = void>
+struct IsBounded : std::false_type {};
+
+template <typename TContainer>
+struct IsBounded<TContainer, std::void_t<decltype(std::declval<TContainer &>().tryPush(0))>> : std::true_type {};
+
+template <typename TContainer>
+bool pushTo(TContainer &container, int value) {
+    if constexpr (IsBounded<TContainer>::value) {
+        return container.tryPush(value);
+    } else {
+        container.push(value);
+        return true;
+    }
+}
+
+template <typename TContainer>
+auto popFrom(TContainer &container) {
+    if constexpr (IsBounded<TContainer>::value) {
+        return container.tryPop();
+    } else {
+        return container.pop();
+    }
+}
+
 template <typename TContainer>
 void stressTest(int actions, int threads) {
     std::vector<std::thread> workers;
@@ -21,10 +56,11 @@ void stressTest(int actions, int threads) {
             for (int j = 0; j < actions / threads; j++) {
                 if (rand() % 2) {
                     int a = rand();
-                    container.push(a);
-                    generated[i].push_back(a);
+                    if (pushTo(container, a)) {
+                        generated[i].push_back(a);
+                    }
                 } else {
-                    auto a = container.pop();
+                    auto a = popFrom(container);
                     if (a) {
                         extracted[i].push_back(*a);
                     }
@@ -52,7 +88,7 @@ void stressTest(int actions, int threads) {
     }
 
     while (true) {
-        auto a = container.pop();
+        auto a = popFrom(container);
         if (a) {
             all_extracted.push_back(*a);
         } else {
@@ -87,6 +123,577 @@ void abstractStressTest(Func &&func) {
     }
 }
 
+template <class TSharedPtr, class TWeakPtr>
+void weakLockTest(const TSharedPtr &shared, int actions, int threads) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    TWeakPtr weak(shared);
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back([actions, &weak, threads]() {
+            for (int j = 0; j < actions / threads; j++) {
+                auto locked = weak.lock();
+                assert(locked);
+            }
+        });
+    }
+
+    for (auto &thread: workers) {
+        thread.join();
+    }
+}
+
+void weakLockCompare() {
+    std::cout << "________________________________Weak lock compare________________________________" << std::endl;
+    std::cout << std::endl
+              << "from std:" << std::endl;
+    abstractStressTest([](int actions, int threads) {
+        weakLockTest<std::shared_ptr<int>, std::weak_ptr<int>>(std::make_shared<int>(0), actions, threads);
+    });
+    std::cout << std::endl
+              << "from me:" << std::endl;
+    abstractStressTest([](int actions, int threads) {
+        weakLockTest<lu::SharedPtr<int>, lu::WeakPtr<int>>(lu::makeShared<int>(0), actions, threads);
+    });
+    std::cout << std::endl;
+}
+
+template <bool Direct>
+void weakObserverTest(int actions, int threads) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    lu::SharedPtr<int> object = lu::makeShared<int>(0);
+    lu::AtomicWeakPtr<int> observed;
+    observed.store(lu::WeakPtr<int>(object));
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back([actions, &observed, threads]() {
+            for (int j = 0; j < actions / threads; j++) {
+                if constexpr (Direct) {
+                    auto locked = observed.lock();
+                    assert(locked);
+                    (void) locked;
+                } else {
+                    auto locked = observed.load().lock();
+                    assert(locked);
+                    (void) locked;
+                }
+            }
+        });
+    }
+
+    for (auto &thread: workers) {
+        thread.join();
+    }
+}
+
+void weakObserverCompare() {
+    std::cout << "______________________________Weak observer compare______________________________" << std::endl;
+    std::cout << std::endl
+              << "load().lock():" << std::endl;
+    abstractStressTest(weakObserverTest<false>);
+    std::cout << std::endl
+              << "lock():" << std::endl;
+    abstractStressTest(weakObserverTest<true>);
+    std::cout << std::endl;
+}
+
+template <bool Cached>
+void readMostlyTest(int actions, int threads) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    lu::AtomicSharedPtr<int> config;
+    config.store(lu::makeShared<int>(0));
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back([i, actions, &config, threads]() {
+            lu::CachedReader<int> reader(config);
+            for (int j = 0; j < actions / threads; j++) {
+                if (i == 0 && j % 100000 == 0) {
+                    config.store(lu::makeShared<int>(j));
+                }
+                if constexpr (Cached) {
+                    auto value = reader.load();
+                    assert(*value >= 0);
+                    (void) value;
+                } else {
+                    auto value = config.load();
+                    assert(*value >= 0);
+                    (void) value;
+                }
+            }
+        });
+    }
+
+    for (auto &thread: workers) {
+        thread.join();
+    }
+}
+
+void readMostlyCompare() {
+    std::cout << "_______________________________Read mostly compare_______________________________" << std::endl;
+    std::cout << std::endl
+              << "load:" << std::endl;
+    abstractStressTest(readMostlyTest<false>);
+    std::cout << std::endl
+              << "cached reader:" << std::endl;
+    abstractStressTest(readMostlyTest<true>);
+    std::cout << std::endl;
+}
+
+template <class TAtomic, class Factory, class Read>
+void slotReadTest(Factory factory, Read read, int actions, int threads) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    TAtomic slot;
+    slot.store(factory(0));
+    // every value read goes into the checksum, so no read variant can be optimized away
+    std::atomic<long long> checksum{0};
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back([i, actions, &slot, &factory, &read, &checksum, threads]() {
+            long long sum = 0;
+            for (int j = 0; j < actions / threads; j++) {
+                if (i == 0 && j % 100000 == 0) {
+                    slot.store(factory(j));
+                }
+                int value = read(slot);
+                assert(value >= 0);
+                sum += value;
+            }
+            checksum.fetch_add(sum);
+        });
+    }
+
+    for (auto &thread: workers) {
+        thread.join();
+    }
+    assert(checksum >= 0);
+}
+
+void slotReadCompare() {
+    std::cout << "________________________________Slot read compare________________________________" << std::endl;
+    std::cout << std::endl
+              << "atomic shared:" << std::endl;
+    abstractStressTest([](int actions, int threads) {
+        slotReadTest<lu::AtomicSharedPtr<int>>(
+                [](int value) { return lu::makeShared<int>(value); },
+                [](const lu::AtomicSharedPtr<int> &slot) { return *slot.load(); }, actions, threads);
+    });
+    std::cout << std::endl
+              << "atomic shared (snapshot):" << std::endl;
+    abstractStressTest([](int actions, int threads) {
+        slotReadTest<lu::AtomicSharedPtr<int>>(
+                [](int value) { return lu::makeShared<int>(value); },
+                [](const lu::AtomicSharedPtr<int> &slot) { return *slot.snapshot(); }, actions, threads);
+    });
+    std::cout << std::endl
+              << "atomic unique:" << std::endl;
+    abstractStressTest([](int actions, int threads) {
+        slotReadTest<lu::AtomicUniquePtr<int>>(
+                [](int value) { return std::make_unique<int>(value); },
+                [](const lu::AtomicUniquePtr<int> &slot) { return *slot.load(); }, actions, threads);
+    });
+    std::cout << std::endl;
+}
+
+template <bool Versioned>
+void pollTest(int actions, int threads) {
+    constexpr int kSlots = 256;
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    std::vector<lu::VersionedAtomicSharedPtr<int>> slots(kSlots);
+    for (auto &slot: slots) {
+        slot.store(lu::makeShared<int>(0));
+    }
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back([i, actions, &slots, threads]() {
+            std::vector<uint64_t> versions(kSlots, lu::VersionedAtomicSharedPtr<int>::kNoVersion);
+            std::vector<lu::SharedPtr<int>> values(kSlots);
+            for (int j = 0; j < actions / threads; j++) {
+                int slot = j % kSlots;
+                if (i == 0 && j % 10000 == 0) {
+                    slots[slot].store(lu::makeShared<int>(j));
+                }
+                if constexpr (Versioned) {
+                    slots[slot].loadIfChanged(versions[slot], values[slot]);
+                } else {
+                    values[slot] = slots[slot].load();
+                }
+                assert(*values[slot] >= 0);
+            }
+        });
+    }
+
+    for (auto &thread: workers) {
+        thread.join();
+    }
+}
+
+void pollCompare() {
+    std::cout << "__________________________________Poll compare___________________________________" << std::endl;
+    std::cout << std::endl
+              << "load:" << std::endl;
+    abstractStressTest(pollTest<false>);
+    std::cout << std::endl
+              << "load if changed:" << std::endl;
+    abstractStressTest(pollTest<true>);
+    std::cout << std::endl;
+}
+
+template <bool Grouped>
+void groupTest(int actions, int threads) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    lu::AtomicSharedPtr<int> schema;
+    lu::AtomicSharedPtr<int> routes;
+    lu::AtomicSharedPtr<int> flags;
+    lu::AtomicSharedGroup<int, int, int> group;
+    group.store(lu::makeShared<int>(0), lu::makeShared<int>(0), lu::makeShared<int>(0));
+    schema.store(lu::makeShared<int>(0));
+    routes.store(lu::makeShared<int>(0));
+    flags.store(lu::makeShared<int>(0));
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back([i, actions, &schema, &routes, &flags, &group, threads]() {
+            for (int j = 0; j < actions / threads; j++) {
+                if (i == 0 && j % 10000 == 0) {
+                    if constexpr (Grouped) {
+                        group.store(lu::makeShared<int>(j), lu::makeShared<int>(j), lu::makeShared<int>(j));
+                    } else {
+                        schema.store(lu::makeShared<int>(j));
+                        routes.store(lu::makeShared<int>(j));
+                        flags.store(lu::makeShared<int>(j));
+                    }
+                }
+                if constexpr (Grouped) {
+                    auto view = group.view();
+                    assert(*view.get<0>() == *view.get<1>() && *view.get<1>() == *view.get<2>());
+                } else {
+                    // independent loads may see a torn combination
+                    auto current_schema = schema.load();
+                    auto current_routes = routes.load();
+                    auto current_flags = flags.load();
+                    assert(*current_schema >= 0 && *current_routes >= 0 && *current_flags >= 0);
+                }
+            }
+        });
+    }
+
+    for (auto &thread: workers) {
+        thread.join();
+    }
+}
+
+void groupCompare() {
+    std::cout << "__________________________________Group compare__________________________________" << std::endl;
+    std::cout << std::endl
+              << "independent loads:" << std::endl;
+    abstractStressTest(groupTest<false>);
+    std::cout << std::endl
+              << "group view:" << std::endl;
+    abstractStressTest(groupTest<true>);
+    std::cout << std::endl;
+}
+
+template <bool Locked>
+void pairTest(int actions, int threads) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    lu::AtomicSharedPtr<long> index;
+    lu::AtomicSharedPtr<long> data;
+    index.store(lu::makeShared<long>(0));
+    data.store(lu::makeShared<long>(0));
+    std::mutex mutex;
+    lu::SharedPtr<long> locked_index = lu::makeShared<long>(0);
+    lu::SharedPtr<long> locked_data = lu::makeShared<long>(0);
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back([actions, &index, &data, &mutex, &locked_index, &locked_data, threads]() {
+            for (int j = 0; j < actions / threads; j++) {
+                if constexpr (Locked) {
+                    std::lock_guard lock(mutex);
+                    locked_index = lu::makeShared<long>(*locked_index + 1);
+                    locked_data = lu::makeShared<long>(*locked_data - 1);
+                } else {
+                    while (true) {
+                        auto current_index = index.load();
+                        auto current_data = data.load();
+                        if (lu::compareExchangeMulti(
+                                    lu::CasEntry(index, current_index, lu::makeShared<long>(*current_index + 1)),
+                                    lu::CasEntry(data, current_data, lu::makeShared<long>(*current_data - 1)))) {
+                            break;
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    for (auto &thread: workers) {
+        thread.join();
+    }
+    if constexpr (Locked) {
+        assert(*locked_index + *locked_data == 0);
+    } else {
+        assert(*index.load() + *data.load() == 0);
+    }
+}
+
+void pairCompare() {
+    std::cout << "__________________________________Pair compare___________________________________" << std::endl;
+    std::cout << std::endl
+              << "mutex:" << std::endl;
+    abstractStressTest(pairTest<true>);
+    std::cout << std::endl
+              << "multi-word cas:" << std::endl;
+    abstractStressTest(pairTest<false>);
+    std::cout << std::endl;
+}
+
+template <bool Locked>
+void setTest(int actions, int threads) {
+    constexpr int kKeys = 64;
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    lu::LockFreeSet<int> set;
+    std::mutex mutex;
+    std::set<int> locked_set;
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back([actions, &set, &mutex, &locked_set, threads, i]() {
+            for (int j = 0; j < actions / threads; j++) {
+                int key = (j * 7 + i) % kKeys;
+                // half of the actions read, the other half insert or erase
+                if constexpr (Locked) {
+                    std::lock_guard lock(mutex);
+                    if (j % 4 == 0) {
+                        locked_set.insert(key);
+                    } else if (j % 4 == 1) {
+                        locked_set.erase(key);
+                    } else {
+                        locked_set.count(key);
+                    }
+                } else {
+                    if (j % 4 == 0) {
+                        set.insert(key);
+                    } else if (j % 4 == 1) {
+                        set.erase(key);
+                    } else {
+                        set.contains(key);
+                    }
+                }
+            }
+        });
+    }
+
+    for (auto &thread: workers) {
+        thread.join();
+    }
+}
+
+void setCompare() {
+    std::cout << "___________________________________Set compare___________________________________" << std::endl;
+    std::cout << std::endl
+              << "mutex and std::set:" << std::endl;
+    abstractStressTest(setTest<true>);
+    std::cout << std::endl
+              << "markable lock-free list:" << std::endl;
+    abstractStressTest(setTest<false>);
+    std::cout << std::endl;
+}
+
+template <bool Ordered>
+void memoryOrderTest(int actions, int threads) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    lu::AtomicSharedPtr<int> counter;
+    counter.store(lu::makeShared<int>(0));
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back([actions, &counter, threads]() {
+            for (int j = 0; j < actions / threads; j++) {
+                if (j % 8 != 0) {
+                    auto value = Ordered ? counter.load(std::memory_order_acquire) : counter.load();
+                    assert(*value >= 0);
+                    (void) value;
+                    continue;
+                }
+                if constexpr (Ordered) {
+                    auto expected = counter.load(std::memory_order_acquire);
+                    while (!counter.compareExchangeWeak(expected, lu::makeShared<int>(*expected + 1),
+                                                        std::memory_order_acq_rel, std::memory_order_acquire)) {}
+                } else {
+                    auto expected = counter.load();
+                    while (!counter.compareExchange(expected, lu::makeShared<int>(*expected + 1))) {}
+                }
+            }
+        });
+    }
+
+    for (auto &thread: workers) {
+        thread.join();
+    }
+}
+
+void memoryOrderCompare() {
+    std::cout << "_______________________________Memory order compare_______________________________" << std::endl;
+    std::cout << std::endl
+              << "seq_cst:" << std::endl;
+    abstractStressTest(memoryOrderTest<false>);
+    std::cout << std::endl
+              << "acquire/acq_rel:" << std::endl;
+    abstractStressTest(memoryOrderTest<true>);
+    std::cout << std::endl;
+}
+
+template <class TPointer, class Factory>
+void copyTest(Factory factory, int actions, int threads) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back([actions, &factory, threads]() {
+            TPointer pointer = factory();
+            std::vector<TPointer> copies(16);
+            for (int j = 0; j < actions / threads; j++) {
+                copies[j % copies.size()] = TPointer(pointer);
+            }
+            assert(*copies.front() == 0);
+        });
+    }
+
+    for (auto &thread: workers) {
+        thread.join();
+    }
+}
+
+void copyCompare() {
+    std::cout << "__________________________________Copy compare___________________________________" << std::endl;
+    std::cout << std::endl
+              << "from std:" << std::endl;
+    auto std_shared = std::make_shared<int>(0);
+    abstractStressTest([&std_shared](int actions, int threads) {
+        copyTest<std::shared_ptr<int>>([&std_shared]() { return std_shared; }, actions, threads);
+    });
+    std::cout << std::endl
+              << "from me (shared, not owner):" << std::endl;
+    auto shared = lu::makeShared<int>(0);
+    abstractStressTest([&shared](int actions, int threads) {
+        copyTest<lu::SharedPtr<int>>([&shared]() { return shared; }, actions, threads);
+    });
+    std::cout << std::endl
+              << "from me (shared, own):" << std::endl;
+    abstractStressTest([](int actions, int threads) {
+        copyTest<lu::SharedPtr<int>>([]() { return lu::makeShared<int>(0); }, actions, threads);
+    });
+    std::cout << std::endl
+              << "from me (shared, biased owner):" << std::endl;
+    abstractStressTest([](int actions, int threads) {
+        copyTest<lu::SharedPtr<int>>([]() { return lu::makeShared<int>(lu::kBiasedCount, 0); }, actions, threads);
+    });
+    std::cout << std::endl
+              << "from me (local):" << std::endl;
+    abstractStressTest([](int actions, int threads) {
+        copyTest<lu::LocalSharedPtr<int>>([]() { return lu::makeLocalShared<int>(0); }, actions, threads);
+    });
+    std::cout << std::endl;
+}
+
+struct Payload {
+    std::atomic<long> hits{0};
+};
+
+void layoutTest(const lu::SharedPtr<Payload> &object, int actions, int threads) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back([actions, &object, threads]() {
+            lu::SharedPtr<Payload> copy;
+            for (int j = 0; j < actions / threads; j++) {
+                if (j % 2 == 0) {
+                    copy = lu::SharedPtr<Payload>(object);
+                } else {
+                    object->hits.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    for (auto &thread: workers) {
+        thread.join();
+    }
+}
+
+void layoutCompare() {
+    std::cout << "_________________________________Layout compare__________________________________" << std::endl;
+    std::cout << std::endl
+              << "inplace:" << std::endl;
+    auto inplace = lu::makeShared<Payload>();
+    abstractStressTest([&inplace](int actions, int threads) {
+        layoutTest(inplace, actions, threads);
+    });
+    std::cout << std::endl
+              << "isolated:" << std::endl;
+    auto isolated = lu::makeShared<Payload>(lu::kIsolatedLayout);
+    abstractStressTest([&isolated](int actions, int threads) {
+        layoutTest(isolated, actions, threads);
+    });
+    std::cout << std::endl;
+}
+
+struct Counters {
+    std::array<long, 16> values{};
+};
+
+template <int Mode>
+void updateTest(int actions, int threads) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    lu::AtomicSharedPtr<Counters> counters;
+    counters.store(lu::makeShared<Counters>());
+    lu::UpdateCombiner<Counters> combiner(counters);
+    actions /= 10;
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back([actions, &counters, &combiner, threads]() {
+            for (int j = 0; j < actions / threads; j++) {
+                if constexpr (Mode == 0) {
+                    auto current = counters.load();
+                    while (true) {
+                        auto next = lu::makeShared<Counters>(*current);
+                        next->values[j % 16]++;
+                        if (counters.compareExchange(current, std::move(next))) {
+                            break;
+                        }
+                    }
+                } else if constexpr (Mode == 1) {
+                    counters.update([j](const Counters *current) {
+                        auto next = lu::makeShared<Counters>(*current);
+                        next->values[j % 16]++;
+                        return next;
+                    });
+                } else {
+                    combiner.update([j](Counters &value) { value.values[j % 16]++; });
+                }
+            }
+        });
+    }
+
+    for (auto &thread: workers) {
+        thread.join();
+    }
+    long total = 0;
+    for (long value: counters.load()->values) {
+        total += value;
+    }
+    assert(total == actions / threads * threads);
+}
+
+void updateCompare() {
+    std::cout << "_________________________________Update compare__________________________________" << std::endl;
+    std::cout << std::endl
+              << "compare exchange loop:" << std::endl;
+    abstractStressTest(updateTest<0>);
+    std::cout << std::endl
+              << "update:" << std::endl;
+    abstractStressTest(updateTest<1>);
+    std::cout << std::endl
+              << "combiner:" << std::endl;
+    abstractStressTest(updateTest<2>);
+    std::cout << std::endl;
+}
+
 void stacksCompare() {
     std::cout << "__________________________________Stack compare__________________________________" << std::endl;
     std::cout << std::endl
@@ -98,6 +705,15 @@ void stacksCompare() {
     std::cout << std::endl
               << "from me:" << std::endl;
     abstractStressTest(stressTest<lu::LockFreeStack<int>>);
+    std::cout << std::endl
+              << "from me (split reference count):" << std::endl;
+    abstractStressTest(stressTest<lu::LockFreeStack<int, lu::SplitRefCount>>);
+    std::cout << std::endl
+              << "from me (slab allocator):" << std::endl;
+    abstractStressTest(stressTest<lu::LockFreeStack<int, lu::HazardPointers<lu::HPolicy<>>, lu::SlabAllocator<int>>>);
+    std::cout << std::endl
+              << "from me (elimination):" << std::endl;
+    abstractStressTest(stressTest<lu::EliminationStack<int>>);
     std::cout << std::endl;
 };
 
@@ -106,10 +722,75 @@ void queueCompare() {
     std::cout << std::endl
               << "from me:" << std::endl;
     abstractStressTest(stressTest<lu::LockFreeQueue<int>>);
+    std::cout << std::endl
+              << "from me (split reference count):" << std::endl;
+    abstractStressTest(stressTest<lu::LockFreeQueue<int, lu::SplitRefCount>>);
+    std::cout << std::endl
+              << "from me (slab allocator):" << std::endl;
+    abstractStressTest(stressTest<lu::LockFreeQueue<int, lu::HazardPointers<lu::HPolicy<>>, lu::SlabAllocator<int>>>);
+    std::cout << std::endl
+              << "from me (segmented):" << std::endl;
+    abstractStressTest(stressTest<lu::SegmentedQueue<int>>);
+    std::cout << std::endl
+              << "from me (segmented, split reference count):" << std::endl;
+    abstractStressTest(stressTest<lu::SegmentedQueue<int, lu::SplitRefCount>>);
+    std::cout << std::endl
+              << "from me (bounded ring):" << std::endl;
+    abstractStressTest(stressTest<lu::BoundedQueue<int>>);
+    std::cout << std::endl;
+};
+
+struct ChainNode {
+    lu::SharedPtr<ChainNode> next;
 };
 
+// the pause of the single release that drops a chain of nodes, the rest of the chain is destroyed afterwards
+void chainDropTest(size_t budget) {
+    lu::setDestructionBudget(budget);
+    for (int length = 250000; length <= 1000000; length += 250000) {
+        lu::SharedPtr<ChainNode> head;
+        for (int i = 0; i < length; i++) {
+            auto node = lu::makeShared<ChainNode>();
+            node->next = std::move(head);
+            head = std::move(node);
+        }
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        head.reset();
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        std::cout << length << "\t" << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
+                  << std::endl;
+        lu::drainPendingDestruction();
+    }
+    lu::setDestructionBudget(SIZE_MAX);
+}
+
+void chainDropCompare() {
+    std::cout << "________________________________Chain drop compare_______________________________" << std::endl;
+    std::cout << std::endl
+              << "unbounded (us):" << std::endl;
+    chainDropTest(SIZE_MAX);
+    std::cout << std::endl
+              << "budget of 1000 (us):" << std::endl;
+    chainDropTest(1000);
+    std::cout << std::endl;
+}
+
 int main() {
+    runChecks();
     stacksCompare();
     queueCompare();
+    weakLockCompare();
+    weakObserverCompare();
+    readMostlyCompare();
+    copyCompare();
+    memoryOrderCompare();
+    layoutCompare();
+    slotReadCompare();
+    updateCompare();
+    pollCompare();
+    pairCompare();
+    groupCompare();
+    setCompare();
+    chainDropCompare();
     return 0;
 }
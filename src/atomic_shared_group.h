@@ -0,0 +1,95 @@
+//
+// Created by ludaludaed on 18.10.2026.
+//
+
+#ifndef ATOMIC_SHARED_POINTER_ATOMIC_SHARED_GROUP_H
+#define ATOMIC_SHARED_POINTER_ATOMIC_SHARED_GROUP_H
+
+#include "atomic_shared_pointer.h"
+#include <tuple>
+
+namespace lu::detail {
+    // A set of shared pointers that are updated together and read as one consistent combination. Every commit
+    // publishes a new immutable tuple through a single AtomicSharedPtr, so a reader protects one pointer and
+    // then reads all members of the same commit. Updating a single member copies the tuple of references.
+    // The members live only inside the group, an existing AtomicSharedPtr cannot become one of them.
+    template <class Reclaimer, class... TValues>
+    class AtomicSharedGroup {
+        using Members = std::tuple<SharedPtr<TValues>...>;
+        using Snapshot = typename AtomicSharedPtr<Members, Reclaimer>::Snapshot;
+
+        template <size_t I>
+        using Member = std::tuple_element_t<I, Members>;
+
+    public:
+        // a protected view of one commit, meant to be short lived like a snapshot
+        class View {
+            friend AtomicSharedGroup;
+
+        public:
+            View(const View &) = delete;
+
+            View(View &&) noexcept = default;
+
+            View &operator=(const View &) = delete;
+
+            View &operator=(View &&) noexcept = default;
+
+            template <size_t I>
+            auto *get() const {
+                return snapshot_ ? std::get<I>(*snapshot_).get() : nullptr;
+            }
+
+            // a reference to one member that may outlive the view
+            template <size_t I>
+            Member<I> share() const {
+                return snapshot_ ? std::get<I>(*snapshot_) : Member<I>{};
+            }
+
+        private:
+            explicit View(Snapshot snapshot) : snapshot_(std::move(snapshot)) {}
+
+        private:
+            Snapshot snapshot_;
+        };
+
+    public:
+        AtomicSharedGroup() = default;
+
+        AtomicSharedGroup(const AtomicSharedGroup &) = delete;
+
+        AtomicSharedGroup(AtomicSharedGroup &&) = delete;
+
+        AtomicSharedGroup &operator=(const AtomicSharedGroup &) = delete;
+
+        AtomicSharedGroup &operator=(AtomicSharedGroup &&) = delete;
+
+        View view(std::memory_order order = std::memory_order_seq_cst) const {
+            return View(members_.snapshot(order));
+        }
+
+        Members load(std::memory_order order = std::memory_order_seq_cst) const {
+            Snapshot current = members_.snapshot(order);
+            return current ? *current : Members{};
+        }
+
+        void store(SharedPtr<TValues>... values) {
+            members_.store(makeShared<Members>(std::move(values)...));
+        }
+
+        // replaces one member and keeps the others of the latest commit
+        template <size_t I>
+        void set(Member<I> value) {
+            members_.update([&value](const Members *current) {
+                SharedPtr<Members> next = current ? makeShared<Members>(*current) : makeShared<Members>();
+                std::get<I>(*next) = value;
+                return next;
+            });
+        }
+
+    private:
+        AtomicSharedPtr<Members, Reclaimer> members_;
+    };
+}// namespace lu::detail
+
+#endif//ATOMIC_SHARED_POINTER_ATOMIC_SHARED_GROUP_H
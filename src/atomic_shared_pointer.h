@@ -5,18 +5,30 @@
 #ifndef ATOMIC_SHARED_POINTER_ATOMIC_SHARED_POINTER_H
 #define ATOMIC_SHARED_POINTER_ATOMIC_SHARED_POINTER_H
 
+#include "biased_ref_count.h"
+#include "futex.h"
+#include "multi_word_cas.h"
 #include "utils.h"
+#include <algorithm>
 #include <atomic>
+#include <cassert>
+#include <cstdint>
 #include <memory>
 
 
 namespace lu::detail {
-    class ControlBlockBase {
+    class ControlBlockBase : private BiasedRefCount {
+        struct PendingGuard {
+            ~PendingGuard() {
+                drainPending(SIZE_MAX);
+            }
+        };
+
     protected:
-        ControlBlockBase() : ref_counter_(1), weak_counter_(1) {}
+        ControlBlockBase() : weak_counter_(1) {}
 
     public:
-        virtual ~ControlBlockBase() = default;
+        ~ControlBlockBase() override = default;
 
         ControlBlockBase(const ControlBlockBase &) = delete;
 
@@ -24,58 +36,97 @@ namespace lu::detail {
 
     public:
         bool incrementNotZeroRef(size_t num_of_refs = 1) {
-            size_t ref_count = ref_counter_.load();
-            while (ref_count != 0) {
-                if (ref_counter_.compare_exchange_strong(ref_count, ref_count + num_of_refs)) {
-                    return true;
-                }
-            }
-            return false;
+            return incrementStrongNotZero(num_of_refs);
         }
 
         void incrementRef(size_t num_of_refs = 1) {
-            ref_counter_.fetch_add(num_of_refs);
+            incrementStrong(num_of_refs);
         }
 
         void incrementWeakRef(size_t num_of_refs = 1) {
-            weak_counter_.fetch_add(num_of_refs);
+            fetchAdd(weak_counter_, num_of_refs, std::memory_order_relaxed);
+        }
+
+        // counts the references of the calling thread without atomics, only before the block is shared
+        void biasToCurrentThread() {
+            bias();
+        }
+
+        // references of a LocalSharedPtr, only on the thread that created the control block
+        void incrementLocalRef() {
+            incrementBiased(1);
+        }
+
+        void decrementLocalRef() {
+            if (decrementBiased(1)) {
+                safetyDestroy();
+            }
         }
 
         void decrementRef(size_t num_of_refs = 1) {
-            if (ref_counter_.fetch_sub(num_of_refs) <= num_of_refs) {
+            if (decrementStrong(num_of_refs)) {
                 safetyDestroy();
             }
         }
 
         void decrementWeakRef(size_t num_of_refs = 1) {
-            if (weak_counter_.fetch_sub(num_of_refs) <= num_of_refs) {
+            if (fetchAdd(weak_counter_, -num_of_refs, std::memory_order_acq_rel) <= num_of_refs) {
                 deleteThis();
             }
         }
 
         size_t useCount() const {
-            return ref_counter_.load(std::memory_order_relaxed);
+            return loadStrong();
         }
 
         virtual void *get() = 0;
 
+        // the block that counts the references of the object, another one than this only for alias blocks
+        virtual ControlBlockBase *owner() {
+            return this;
+        }
+
+        // limits the number of objects a thread destroys per released reference, the rest stay pending until a
+        // later release, drainPendingDestruction() or thread exit; SIZE_MAX destroys everything right away.
+        // Allocations never destroy pending objects, so no destructor runs inside makeShared()
+        static void setDestructionBudget(size_t budget) {
+            assert(budget != 0 && "Budget must allow some progress");
+            destruction_budget_ = budget;
+        }
+
+        // destroys up to max_blocks pending objects of the calling thread and returns how many were destroyed
+        static size_t drainPending(size_t max_blocks) {
+            if (destroy_in_progress_) {
+                return 0;
+            }
+            destroy_in_progress_ = true;
+            size_t destroyed = 0;
+            while (pending_ != nullptr && destroyed < max_blocks) {
+                auto poped = pending_;
+                pending_ = poped->next_;
+                poped->destroy();
+                poped->decrementWeakRef();
+                ++destroyed;
+            }
+            destroy_in_progress_ = false;
+            return destroyed;
+        }
+
     private:
+        void releaseStrong() override {
+            safetyDestroy();
+        }
+
         void safetyDestroy() {
-            thread_local ControlBlockBase *head{nullptr};
-            thread_local bool in_progress{false};
-
-            next_ = head;
-            head = this;
-
-            if (!in_progress) {
-                in_progress = true;
-                while (head != nullptr) {
-                    auto poped = head;
-                    head = head->next_;
-                    poped->destroy();
-                    poped->decrementWeakRef();
+            next_ = pending_;
+            pending_ = this;
+
+            if (!destroy_in_progress_) {
+                drainPending(destruction_budget_);
+                if (pending_ != nullptr) {
+                    // whatever is left when the thread exits is destroyed then
+                    thread_local PendingGuard guard;
                 }
-                in_progress = false;
             }
         }
 
@@ -84,8 +135,11 @@ namespace lu::detail {
         virtual void deleteThis() = 0;
 
     private:
+        static inline thread_local ControlBlockBase *pending_{nullptr};
+        static inline thread_local bool destroy_in_progress_{false};
+        static inline thread_local size_t destruction_budget_{SIZE_MAX};
+
         ControlBlockBase *next_{nullptr};
-        std::atomic<size_t> ref_counter_;
         std::atomic<size_t> weak_counter_;
     };
 
@@ -182,6 +236,333 @@ namespace lu::detail {
         InternalAllocator allocator_;
     };
 
+    // Keeps the value in a separate allocation that is freed as soon as the object is destroyed, only the control
+    // block itself waits for the last weak reference.
+    template <class TValue, class Destructor, class Allocator>
+    class SplitControlBlock : public ControlBlockBase {
+    private:
+        using InternalAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<SplitControlBlock>;
+        using StorageAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<AlignedStorage<TValue>>;
+
+    public:
+        explicit SplitControlBlock(AlignedStorage<TValue> *storage, Destructor destructor, const Allocator &allocator)
+            : ControlBlockBase(),
+              storage_(storage),
+              destructor_(std::move(destructor)),
+              allocator_(allocator) {}
+
+        ~SplitControlBlock() override = default;
+
+        void *get() override {
+            return &*storage_;
+        }
+
+        template <class... Args>
+        static SplitControlBlock *create(Destructor destructor, const Allocator &allocator, Args &&...args) {
+            InternalAllocator internal_allocator(allocator);
+            AllocateGuard allocation(internal_allocator);
+            allocation.allocate();
+            StorageAllocator storage_allocator(allocator);
+            AllocateGuard storage(storage_allocator);
+            storage.allocate();
+            storage.ptr()->construct(std::forward<Args>(args)...);
+            try {
+                allocation.construct(storage.ptr(), std::move(destructor), allocator);
+            } catch (...) {
+                // the storage guard frees the memory of the value
+                storage.ptr()->destruct();
+                throw;
+            }
+            storage.release();
+            return allocation.release();
+        }
+
+    private:
+        void destroy() override {
+            using AllocatorTraits = std::allocator_traits<StorageAllocator>;
+            destructor_(&*storage_);
+            StorageAllocator storage_allocator(allocator_);
+            AllocatorTraits::deallocate(storage_allocator, storage_, 1);
+        }
+
+        void deleteThis() override {
+            using AllocatorTraits = std::allocator_traits<InternalAllocator>;
+            InternalAllocator allocator = allocator_;
+            this->~SplitControlBlock();
+            AllocatorTraits::deallocate(allocator, this, 1);
+        }
+
+    private:
+        AlignedStorage<TValue> *storage_;
+        Destructor destructor_;
+        InternalAllocator allocator_;
+    };
+
+    // Puts the value on cache lines of its own, apart from the counters and the rest of the control block, so writes
+    // to the object do not slow down references taken on other threads and vice versa.
+    template <class TValue, class Destructor, class Allocator>
+    class alignas(kCacheLineSize) IsolatedControlBlock : public ControlBlockBase {
+    private:
+        using InternalAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<IsolatedControlBlock>;
+
+        static constexpr size_t kValueAlignment = std::max(kCacheLineSize, alignof(TValue));
+
+    public:
+        template <class... Args>
+        explicit IsolatedControlBlock(Destructor destructor, const Allocator &allocator, Args &&...args)
+            : ControlBlockBase(),
+              destructor_(std::move(destructor)),
+              allocator_(allocator) {
+            value_.construct(std::forward<Args>(args)...);
+        }
+
+        ~IsolatedControlBlock() override = default;
+
+        void *get() override {
+            return &value_;
+        }
+
+        template <class... Args>
+        static IsolatedControlBlock *create(Destructor destructor, const Allocator &allocator, Args &&...args) {
+            InternalAllocator internal_allocator(allocator);
+            AllocateGuard allocation(internal_allocator);
+            allocation.allocate();
+            allocation.construct(std::move(destructor), allocator, std::forward<Args>(args)...);
+            return allocation.release();
+        }
+
+    private:
+        void destroy() override {
+            destructor_(&value_);
+        }
+
+        void deleteThis() override {
+            using AllocatorTraits = std::allocator_traits<InternalAllocator>;
+            InternalAllocator allocator = allocator_;
+            this->~IsolatedControlBlock();
+            AllocatorTraits::deallocate(allocator, this, 1);
+        }
+
+    private:
+        Destructor destructor_;
+        InternalAllocator allocator_;
+        alignas(kValueAlignment) AlignedStorage<TValue> value_;
+    };
+
+    struct SplitLayout {};
+
+    // keeps the value in an allocation of its own, freed when the last strong reference is gone
+    inline constexpr SplitLayout kSplitLayout{};
+
+    struct IsolatedLayout {};
+
+    // requests cache line isolation of the value from the counters, the allocator has to honor over-alignment
+    inline constexpr IsolatedLayout kIsolatedLayout{};
+
+    struct BiasedCount {};
+
+    // counts the references of the creating thread in a plain biased counter; a release of the last reference on
+    // another thread then waits for the creating thread's next release, allocation or exit to destroy the object
+    inline constexpr BiasedCount kBiasedCount{};
+
+    template <class TValue>
+    inline constexpr bool kIsAllocationTag = std::is_same_v<std::decay_t<TValue>, SplitLayout> ||
+                                             std::is_same_v<std::decay_t<TValue>, IsolatedLayout> ||
+                                             std::is_same_v<std::decay_t<TValue>, BiasedCount>;
+
+    // Array of elements placed right after the control block in the same allocation.
+    template <class TElement, class Allocator>
+    class InplaceArrayControlBlock : public ControlBlockBase {
+    private:
+        static constexpr size_t kAlignment = std::max(alignof(TElement), alignof(ControlBlockBase));
+
+        struct alignas(kAlignment) Unit {
+            std::byte data[kAlignment];
+        };
+
+        using InternalAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Unit>;
+
+    public:
+        explicit InplaceArrayControlBlock(const Allocator &allocator, size_t count)
+            : ControlBlockBase(),
+              allocator_(allocator),
+              count_(count) {}
+
+        ~InplaceArrayControlBlock() override = default;
+
+        void *get() override {
+            return elements();
+        }
+
+        template <class... Args>
+        static InplaceArrayControlBlock *create(DefaultDestructor, const Allocator &allocator, size_t count,
+                                                const Args &...args) {
+            static_assert(sizeof...(Args) <= 1, "Arrays are built from at most one initial value");
+            InternalAllocator internal_allocator(allocator);
+            size_t units = unitsFor(count);
+            Unit *memory = std::allocator_traits<InternalAllocator>::allocate(internal_allocator, units);
+            InplaceArrayControlBlock *control_block = nullptr;
+            size_t constructed = 0;
+            try {
+                control_block = ::new(memory) InplaceArrayControlBlock(allocator, count);
+                TElement *elements = control_block->elements();
+                for (; constructed < count; ++constructed) {
+                    ::new(elements + constructed) TElement(args...);
+                }
+            } catch (...) {
+                if (control_block != nullptr) {
+                    control_block->destroyElements(constructed);
+                    control_block->~InplaceArrayControlBlock();
+                }
+                std::allocator_traits<InternalAllocator>::deallocate(internal_allocator, memory, units);
+                throw;
+            }
+            return control_block;
+        }
+
+    private:
+        static constexpr size_t elementsOffset() {
+            return (sizeof(InplaceArrayControlBlock) + alignof(TElement) - 1) / alignof(TElement) * alignof(TElement);
+        }
+
+        static size_t unitsFor(size_t count) {
+            return (elementsOffset() + count * sizeof(TElement) + sizeof(Unit) - 1) / sizeof(Unit);
+        }
+
+        TElement *elements() {
+            return reinterpret_cast<TElement *>(reinterpret_cast<std::byte *>(this) + elementsOffset());
+        }
+
+        void destroyElements(size_t count) {
+            TElement *elements = this->elements();
+            while (count != 0) {
+                elements[--count].~TElement();
+            }
+        }
+
+        void destroy() override {
+            destroyElements(count_);
+        }
+
+        void deleteThis() override {
+            using AllocatorTraits = std::allocator_traits<InternalAllocator>;
+            InternalAllocator allocator = allocator_;
+            size_t units = unitsFor(count_);
+            this->~InplaceArrayControlBlock();
+            AllocatorTraits::deallocate(allocator, reinterpret_cast<Unit *>(this), units);
+        }
+
+    private:
+        InternalAllocator allocator_;
+        size_t count_;
+    };
+
+    // Pairs a value pointer that differs from the object of its control block, e.g. a member or a base class view,
+    // with a control block of its own. AtomicSharedPtr stores only control blocks and derives the value from them.
+    class AliasControlBlock : public ControlBlockBase {
+    private:
+        using InternalAllocator = std::allocator<AliasControlBlock>;
+
+    public:
+        // takes over a strong reference to owner
+        AliasControlBlock(ControlBlockBase *owner, void *value) : ControlBlockBase(), owner_(owner), value_(value) {}
+
+        ~AliasControlBlock() override = default;
+
+        void *get() override {
+            return value_;
+        }
+
+        ControlBlockBase *owner() override {
+            return owner_;
+        }
+
+        static AliasControlBlock *create(ControlBlockBase *owner, void *value) {
+            InternalAllocator allocator;
+            AllocateGuard allocation(allocator);
+            allocation.allocate();
+            allocation.construct(owner, value);
+            return allocation.release();
+        }
+
+    private:
+        void destroy() override {
+            owner_->decrementRef();
+        }
+
+        void deleteThis() override {
+            using AllocatorTraits = std::allocator_traits<InternalAllocator>;
+            InternalAllocator allocator;
+            this->~AliasControlBlock();
+            AllocatorTraits::deallocate(allocator, this, 1);
+        }
+
+    private:
+        ControlBlockBase *owner_;
+        void *value_;
+    };
+
+    // The weak counterpart of AliasControlBlock for AtomicWeakPtr. It holds a weak reference to owner and only its
+    // weak count is used, the object stays alive exactly as long as the owner's strong references. AtomicWeakPtr
+    // resolves it to the owner and the value, so it never leaves the atomic.
+    class WeakAliasControlBlock : public ControlBlockBase {
+    private:
+        using InternalAllocator = std::allocator<WeakAliasControlBlock>;
+
+    public:
+        // takes over a weak reference to owner
+        WeakAliasControlBlock(ControlBlockBase *owner, void *value)
+            : ControlBlockBase(), owner_(owner), value_(value) {}
+
+        ~WeakAliasControlBlock() override = default;
+
+        void *get() override {
+            return value_;
+        }
+
+        ControlBlockBase *owner() override {
+            return owner_;
+        }
+
+        static WeakAliasControlBlock *create(ControlBlockBase *owner, void *value) {
+            InternalAllocator allocator;
+            AllocateGuard allocation(allocator);
+            allocation.allocate();
+            allocation.construct(owner, value);
+            return allocation.release();
+        }
+
+    private:
+        // the strong reference the block is created with is never released
+        void destroy() override {}
+
+        void deleteThis() override {
+            using AllocatorTraits = std::allocator_traits<InternalAllocator>;
+            InternalAllocator allocator;
+            ControlBlockBase *owner = owner_;
+            this->~WeakAliasControlBlock();
+            AllocatorTraits::deallocate(allocator, this, 1);
+            owner->decrementWeakRef();
+        }
+
+    private:
+        ControlBlockBase *owner_;
+        void *value_;
+    };
+
+    template <class TValue, class Allocator>
+    struct DefaultControlBlockOf {
+        using type = InplaceControlBlock<TValue, DefaultDestructor, Allocator>;
+    };
+
+    template <class TElement, class Allocator>
+    struct DefaultControlBlockOf<TElement[], Allocator> {
+        using type = InplaceArrayControlBlock<TElement, Allocator>;
+    };
+
+    template <class TValue, class Allocator>
+    using DefaultControlBlock = typename DefaultControlBlockOf<TValue, Allocator>::type;
+
     template <class TValue>
     class SharedPtr;
 
@@ -189,12 +570,25 @@ namespace lu::detail {
     class WeakPtr;
 
     template <class TValue>
-    class SharedPtr {
-        template <class TTValue, class Allocator, class... Args>
-        friend SharedPtr<TTValue> allocateShared(const Allocator &allocator, Args &&...args);
+    class LocalSharedPtr;
 
-        template <class TTValue, class... Args>
-        friend SharedPtr<TTValue> makeShared(Args &&...args);
+    template <class TValue>
+    class EnableSharedFromThis;
+
+    // only for the detection of an EnableSharedFromThis base, never defined
+    template <class TValue>
+    TValue *sharedFromThisBase(const EnableSharedFromThis<TValue> *);
+
+    template <class TValue, class = void>
+    inline constexpr bool kHasSharedFromThis = false;
+
+    template <class TValue>
+    inline constexpr bool kHasSharedFromThis<TValue, std::void_t<decltype(sharedFromThisBase(std::declval<TValue *>()))>> = true;
+
+    template <class TValue>
+    class SharedPtr {
+        template <class TTValue, class ControlBlock, class Allocator, class... Args>
+        friend SharedPtr<TTValue> allocateSharedWith(bool biased, const Allocator &allocator, Args &&...args);
 
         template <class TTValue>
         friend class WeakPtr;
@@ -202,17 +596,38 @@ namespace lu::detail {
         template <class TTValue>
         friend class SharedPtr;
 
+        template <class TTValue>
+        friend class LocalSharedPtr;
+
         template <class TTValue, class Reclaimer>
         friend class AtomicSharedPtr;
 
+        template <class TTValue, class Reclaimer>
+        friend class SnapshotPtr;
+
+        template <class TTValue, class Reclaimer>
+        friend class MarkableAtomicSharedPtr;
+
+        template <class TTValue, class Reclaimer>
+        friend class CasEntry;
+
+        template <class TTValue, class Reclaimer>
+        friend class AtomicWeakPtr;
+
+        template <class TTValue>
+        friend class EnableSharedFromThis;
+
     public:
-        using element_type = TValue;
+        using element_type = std::remove_extent_t<TValue>;
 
     private:
         // only for atomic shared pointer
         explicit SharedPtr(ControlBlockBase *control_block)
             : control_block_(control_block),
-              value_(reinterpret_cast<TValue *>(control_block->get())) {}
+              value_(control_block != nullptr ? reinterpret_cast<element_type *>(control_block->get()) : nullptr) {}
+
+        SharedPtr(ControlBlockBase *control_block, element_type *value)
+            : control_block_(control_block), value_(value) {}
 
         ControlBlockBase *release() {
             auto old = control_block_;
@@ -266,6 +681,22 @@ namespace lu::detail {
             other.value_ = nullptr;
         }
 
+        // shares ownership with owner but points to value, typically a member of the owned object
+        template <class TTValue>
+        SharedPtr(const SharedPtr<TTValue> &owner, element_type *value)
+            : control_block_(owner.control_block_), value_(value) {
+            if (control_block_ != nullptr) {
+                control_block_->incrementRef();
+            }
+        }
+
+        template <class TTValue>
+        SharedPtr(SharedPtr<TTValue> &&owner, element_type *value)
+            : control_block_(owner.control_block_), value_(value) {
+            owner.control_block_ = nullptr;
+            owner.value_ = nullptr;
+        }
+
         template <class TTValue, std::enable_if_t<std::is_convertible_v<TTValue *, TValue *>, int> = 0>
         explicit SharedPtr(const WeakPtr<TTValue> &other) {
             if (other.control_block_ != nullptr && other.control_block_->incrementNotZeroRef()) {
@@ -274,6 +705,14 @@ namespace lu::detail {
             }
         }
 
+        template <class TTValue, std::enable_if_t<std::is_convertible_v<TTValue *, TValue *>, int> = 0>
+        explicit SharedPtr(const LocalSharedPtr<TTValue> &other)
+            : control_block_(other.control_block_), value_(other.value_) {
+            if (control_block_ != nullptr) {
+                control_block_->incrementRef();
+            }
+        }
+
         ~SharedPtr() {
             if (control_block_ != nullptr) {
                 control_block_->decrementRef();
@@ -338,14 +777,23 @@ namespace lu::detail {
             return control_block_ != nullptr;
         }
 
-        TValue &operator*() const {
+        element_type &operator*() const {
             return *value_;
         }
 
-        TValue *operator->() const {
+        element_type *operator->() const {
+            return value_;
+        }
+
+        element_type *get() const {
             return value_;
         }
 
+        element_type &operator[](std::ptrdiff_t index) const {
+            static_assert(std::is_array_v<TValue>, "Only for arrays");
+            return value_[index];
+        }
+
         [[nodiscard]] long useCount() const {
             if (control_block_ != nullptr) {
                 return control_block_->useCount();
@@ -396,25 +844,232 @@ namespace lu::detail {
         void setPointers(TTValue *value, ControlBlockBase *control_block) {
             control_block_ = control_block;
             value_ = value;
-        }
+            if constexpr (!std::is_array_v<TValue> && kHasSharedFromThis<TTValue>) {
+                if (value != nullptr) {
+                    value->acceptOwner(*this);
+                }
+            }
+        }
+
+        bool isAliased() const {
+            return control_block_ != nullptr &&
+                   const_cast<void *>(static_cast<const volatile void *>(value_)) != control_block_->get();
+        }
+
+        // gives an aliased pointer a control block of its own before it is stored in an AtomicSharedPtr
+        void unalias() {
+            if (isAliased()) {
+                control_block_ = AliasControlBlock::create(control_block_,
+                                                           const_cast<void *>(static_cast<const volatile void *>(value_)));
+            }
+        }
 
     private:
         ControlBlockBase *control_block_{nullptr};
-        TValue *value_{nullptr};
+        element_type *value_{nullptr};
     };
 
-    template <class TValue, class Allocator, class... Args>
-    SharedPtr<TValue> allocateShared(const Allocator &allocator, Args &&...args) {
-        using ControlBlock = InplaceControlBlock<TValue, DefaultDestructor, Allocator>;
+    template <class TValue, class ControlBlock, class Allocator, class... Args>
+    SharedPtr<TValue> allocateSharedWith(bool biased, const Allocator &allocator, Args &&...args) {
         auto control_block = ControlBlock::create(DefaultDestructor{}, allocator, std::forward<Args>(args)...);
+        if (biased) {
+            control_block->biasToCurrentThread();
+        }
         SharedPtr<TValue> result;
-        result.setPointers(reinterpret_cast<TValue *>(control_block->get()), control_block);
+        result.setPointers(reinterpret_cast<std::remove_extent_t<TValue> *>(control_block->get()), control_block);
         return std::move(result);
     }
 
+    template <class TValue, class Allocator, class... Args, std::enable_if_t<!kIsAllocationTag<Allocator>, int> = 0>
+    SharedPtr<TValue> allocateShared(const Allocator &allocator, Args &&...args) {
+        using ControlBlock = DefaultControlBlock<TValue, Allocator>;
+        return allocateSharedWith<TValue, ControlBlock>(false, allocator, std::forward<Args>(args)...);
+    }
+
+    template <class TValue, class Allocator, class... Args>
+    SharedPtr<TValue> allocateShared(SplitLayout, const Allocator &allocator, Args &&...args) {
+        using ControlBlock = SplitControlBlock<TValue, DefaultDestructor, Allocator>;
+        return allocateSharedWith<TValue, ControlBlock>(false, allocator, std::forward<Args>(args)...);
+    }
+
+    template <class TValue, class Allocator, class... Args>
+    SharedPtr<TValue> allocateShared(IsolatedLayout, const Allocator &allocator, Args &&...args) {
+        using ControlBlock = IsolatedControlBlock<TValue, DefaultDestructor, Allocator>;
+        return allocateSharedWith<TValue, ControlBlock>(false, allocator, std::forward<Args>(args)...);
+    }
+
+    template <class TValue, class Allocator, class... Args>
+    SharedPtr<TValue> allocateShared(BiasedCount, const Allocator &allocator, Args &&...args) {
+        using ControlBlock = DefaultControlBlock<TValue, Allocator>;
+        return allocateSharedWith<TValue, ControlBlock>(true, allocator, std::forward<Args>(args)...);
+    }
+
+    // makeShared<T[]>(count) and makeShared<T[]>(count, value) build an array of count elements
     template <class TValue, class... Args>
     SharedPtr<TValue> makeShared(Args &&...args) {
-        return std::move(allocateShared<TValue>(std::allocator<TValue>{}, std::forward<Args>(args)...));
+        using Allocator = std::allocator<std::remove_extent_t<TValue>>;
+        return std::move(allocateShared<TValue>(Allocator{}, std::forward<Args>(args)...));
+    }
+
+    template <class TValue, class... Args>
+    SharedPtr<TValue> makeShared(SplitLayout layout, Args &&...args) {
+        return std::move(allocateShared<TValue>(layout, std::allocator<TValue>{}, std::forward<Args>(args)...));
+    }
+
+    template <class TValue, class... Args>
+    SharedPtr<TValue> makeShared(IsolatedLayout layout, Args &&...args) {
+        return std::move(allocateShared<TValue>(layout, std::allocator<TValue>{}, std::forward<Args>(args)...));
+    }
+
+    template <class TValue, class... Args>
+    SharedPtr<TValue> makeShared(BiasedCount count, Args &&...args) {
+        using Allocator = std::allocator<std::remove_extent_t<TValue>>;
+        return std::move(allocateShared<TValue>(count, Allocator{}, std::forward<Args>(args)...));
+    }
+
+    // Shared pointer confined to the thread that created the object. Copies only update the plain biased counter
+    // of the control block, so a LocalSharedPtr must neither leave its thread nor outlive it. Convert it into a
+    // SharedPtr before the object escapes to other threads.
+    template <class TValue>
+    class LocalSharedPtr {
+        template <class TTValue, class Allocator, class... Args>
+        friend LocalSharedPtr<TTValue> allocateLocalShared(const Allocator &allocator, Args &&...args);
+
+        template <class TTValue>
+        friend class LocalSharedPtr;
+
+        template <class TTValue>
+        friend class SharedPtr;
+
+    public:
+        using element_type = TValue;
+
+    public:
+        LocalSharedPtr() = default;
+
+        LocalSharedPtr(const LocalSharedPtr &other)
+            : control_block_(other.control_block_), value_(other.value_) {
+            if (control_block_ != nullptr) {
+                control_block_->incrementLocalRef();
+            }
+        }
+
+        template <class TTValue, std::enable_if_t<std::is_convertible_v<TTValue *, TValue *>, int> = 0>
+        LocalSharedPtr(const LocalSharedPtr<TTValue> &other)
+            : control_block_(other.control_block_), value_(other.value_) {
+            if (control_block_ != nullptr) {
+                control_block_->incrementLocalRef();
+            }
+        }
+
+        LocalSharedPtr(LocalSharedPtr &&other) noexcept : control_block_(other.control_block_), value_(other.value_) {
+            other.control_block_ = nullptr;
+            other.value_ = nullptr;
+        }
+
+        template <class TTValue, std::enable_if_t<std::is_convertible_v<TTValue *, TValue *>, int> = 0>
+        LocalSharedPtr(LocalSharedPtr<TTValue> &&other)
+            : control_block_(other.control_block_), value_(other.value_) {
+            other.control_block_ = nullptr;
+            other.value_ = nullptr;
+        }
+
+        ~LocalSharedPtr() {
+            if (control_block_ != nullptr) {
+                control_block_->decrementLocalRef();
+            }
+        }
+
+        LocalSharedPtr &operator=(const LocalSharedPtr &other) {
+            LocalSharedPtr temp(other);
+            swap(temp);
+            return *this;
+        }
+
+        template <class TTValue, std::enable_if_t<std::is_convertible_v<TTValue *, TValue *>, int> = 0>
+        LocalSharedPtr &operator=(const LocalSharedPtr<TTValue> &other) {
+            LocalSharedPtr temp(other);
+            swap(temp);
+            return *this;
+        }
+
+        LocalSharedPtr &operator=(LocalSharedPtr &&other) noexcept {
+            LocalSharedPtr temp(std::move(other));
+            swap(temp);
+            return *this;
+        }
+
+        template <class TTValue, std::enable_if_t<std::is_convertible_v<TTValue *, TValue *>, int> = 0>
+        LocalSharedPtr &operator=(LocalSharedPtr<TTValue> &&other) {
+            LocalSharedPtr temp(std::move(other));
+            swap(temp);
+            return *this;
+        }
+
+        void swap(LocalSharedPtr &other) {
+            std::swap(control_block_, other.control_block_);
+            std::swap(value_, other.value_);
+        }
+
+        void reset() {
+            LocalSharedPtr temp;
+            swap(temp);
+        }
+
+        explicit operator bool() const {
+            return control_block_ != nullptr;
+        }
+
+        TValue &operator*() const {
+            return *value_;
+        }
+
+        TValue *operator->() const {
+            return value_;
+        }
+
+        TValue *get() const {
+            return value_;
+        }
+
+        [[nodiscard]] long useCount() const {
+            if (control_block_ != nullptr) {
+                return control_block_->useCount();
+            } else {
+                return 0;
+            }
+        }
+
+    private:
+        ControlBlockBase *control_block_{nullptr};
+        TValue *value_{nullptr};
+    };
+
+    template <class TValue, class Allocator, class... Args>
+    LocalSharedPtr<TValue> allocateLocalShared(const Allocator &allocator, Args &&...args) {
+        using ControlBlock = DefaultControlBlock<TValue, Allocator>;
+        auto control_block = ControlBlock::create(DefaultDestructor{}, allocator, std::forward<Args>(args)...);
+        control_block->biasToCurrentThread();
+        LocalSharedPtr<TValue> result;
+        result.control_block_ = control_block;
+        result.value_ = reinterpret_cast<TValue *>(control_block->get());
+        if constexpr (kHasSharedFromThis<TValue>) {
+            result.value_->acceptOwner(SharedPtr<TValue>(result));
+        }
+        return result;
+    }
+
+    template <class TValue, class... Args>
+    LocalSharedPtr<TValue> makeLocalShared(Args &&...args) {
+        return allocateLocalShared<TValue>(std::allocator<TValue>{}, std::forward<Args>(args)...);
+    }
+
+    inline void setDestructionBudget(size_t budget) {
+        ControlBlockBase::setDestructionBudget(budget);
+    }
+
+    inline size_t drainPendingDestruction(size_t max_blocks = SIZE_MAX) {
+        return ControlBlockBase::drainPending(max_blocks);
     }
 
     template <class TValue>
@@ -429,13 +1084,15 @@ namespace lu::detail {
         friend class AtomicWeakPtr;
 
     public:
-        using element_type = TValue;
+        using element_type = std::remove_extent_t<TValue>;
 
     private:
         // only for atomic shared pointer
         explicit WeakPtr(ControlBlockBase *control_block)
             : control_block_(control_block),
-              value_(reinterpret_cast<TValue *>(control_block->get())) {}
+              value_(control_block != nullptr ? reinterpret_cast<element_type *>(control_block->get()) : nullptr) {}
+
+        WeakPtr(ControlBlockBase *control_block, element_type *value) : control_block_(control_block), value_(value) {}
 
         ControlBlockBase *release() {
             auto old = control_block_;
@@ -532,7 +1189,7 @@ namespace lu::detail {
         }
 
         [[nodiscard]] bool expired() const {
-            return control_block_ != nullptr;
+            return useCount() == 0;
         }
 
         [[nodiscard]] long useCount() const {
@@ -548,11 +1205,100 @@ namespace lu::detail {
             return std::move(result);
         }
 
+    private:
+        bool isAliased() const {
+            return control_block_ != nullptr &&
+                   const_cast<void *>(static_cast<const volatile void *>(value_)) != control_block_->get();
+        }
+
     private:
         ControlBlockBase *control_block_{nullptr};
-        TValue *value_{nullptr};
+        element_type *value_{nullptr};
     };
 
+    template <class TValue, class TTValue>
+    SharedPtr<TValue> staticPointerCast(const SharedPtr<TTValue> &ptr) {
+        return SharedPtr<TValue>(ptr, static_cast<typename SharedPtr<TValue>::element_type *>(ptr.get()));
+    }
+
+    template <class TValue, class TTValue>
+    SharedPtr<TValue> dynamicPointerCast(const SharedPtr<TTValue> &ptr) {
+        auto *value = dynamic_cast<typename SharedPtr<TValue>::element_type *>(ptr.get());
+        return value != nullptr ? SharedPtr<TValue>(ptr, value) : SharedPtr<TValue>{};
+    }
+
+    template <class TValue, class TTValue>
+    SharedPtr<TValue> constPointerCast(const SharedPtr<TTValue> &ptr) {
+        return SharedPtr<TValue>(ptr, const_cast<typename SharedPtr<TValue>::element_type *>(ptr.get()));
+    }
+
+    template <class TValue, class TTValue>
+    SharedPtr<TValue> reinterpretPointerCast(const SharedPtr<TTValue> &ptr) {
+        return SharedPtr<TValue>(ptr, reinterpret_cast<typename SharedPtr<TValue>::element_type *>(ptr.get()));
+    }
+
+    // Base for objects that hand out SharedPtr to themselves. The weak reference is set when a SharedPtr takes
+    // ownership of the object through makeShared(), allocateShared() or a raw pointer constructor.
+    template <class TValue>
+    class EnableSharedFromThis {
+        template <class TTValue>
+        friend class SharedPtr;
+
+        template <class TTValue, class Allocator, class... Args>
+        friend LocalSharedPtr<TTValue> allocateLocalShared(const Allocator &allocator, Args &&...args);
+
+    protected:
+        EnableSharedFromThis() = default;
+
+        EnableSharedFromThis(const EnableSharedFromThis &) {}
+
+        ~EnableSharedFromThis() = default;
+
+        EnableSharedFromThis &operator=(const EnableSharedFromThis &) {
+            return *this;
+        }
+
+    public:
+        SharedPtr<TValue> sharedFromThis() {
+            SharedPtr<TValue> result(weak_this_);
+            if (!result) {
+                throw std::bad_weak_ptr();
+            }
+            return result;
+        }
+
+        SharedPtr<const TValue> sharedFromThis() const {
+            SharedPtr<const TValue> result(weak_this_);
+            if (!result) {
+                throw std::bad_weak_ptr();
+            }
+            return result;
+        }
+
+        WeakPtr<TValue> weakFromThis() {
+            return weak_this_;
+        }
+
+        WeakPtr<const TValue> weakFromThis() const {
+            return weak_this_;
+        }
+
+    private:
+        template <class TTValue>
+        void acceptOwner(const SharedPtr<TTValue> &owner) const {
+            if (weak_this_.expired()) {
+                auto *value = const_cast<TValue *>(static_cast<const TValue *>(this));
+                weak_this_ = SharedPtr<TValue>(owner, value);
+            }
+        }
+
+    private:
+        mutable WeakPtr<TValue> weak_this_;
+    };
+
+    template <class TValue, class Reclaimer>
+    class CachedReader;
+
     template <class Reclaimer>
     class ReclaimerTraits {
     public:
@@ -560,8 +1306,14 @@ namespace lu::detail {
 
         using GuardedPtr = typename Domain::template GuardedPtr<ControlBlockBase>;
 
-        static GuardedPtr protect(const std::atomic<ControlBlockBase *> &ptr) {
-            return reclaimer.protect(ptr);
+        static GuardedPtr protect(const std::atomic<ControlBlockBase *> &ptr,
+                                  std::memory_order order = std::memory_order_seq_cst) {
+            return reclaimer.protect(ptr, order);
+        }
+
+        static GuardedPtr protectTagged(const std::atomic<ControlBlockBase *> &ptr, uintptr_t tag_mask, uintptr_t &tag,
+                                        std::memory_order order = std::memory_order_seq_cst) {
+            return reclaimer.protectTagged(ptr, tag_mask, tag, order);
         }
 
         static void delayDecrementRef(ControlBlockBase *control_block) {
@@ -586,11 +1338,92 @@ namespace lu::detail {
         static inline Domain &reclaimer = Domain::instance();
     };
 
+    // A view of the value an AtomicSharedPtr stored when the snapshot was taken. The control block is kept alive
+    // by a hazard pointer instead of a reference, so taking and dropping a snapshot leaves the counter untouched.
+    // Snapshots are bound to the scope and thread that took them, promote() makes a SharedPtr that may outlive it.
+    template <class TValue, class Reclaimer>
+    class SnapshotPtr {
+        template <class TTValue, class TReclaimer>
+        friend class AtomicSharedPtr;
+
+        using GuardedPtr = typename ReclaimerTraits<Reclaimer>::GuardedPtr;
+
+    public:
+        using element_type = std::remove_extent_t<TValue>;
+
+        SnapshotPtr() = default;
+
+        SnapshotPtr(const SnapshotPtr &) = delete;
+
+        // a moved-from snapshot is empty, its value is no longer protected
+        SnapshotPtr(SnapshotPtr &&other) noexcept
+            : guarded_(std::move(other.guarded_)), value_(std::exchange(other.value_, nullptr)) {}
+
+        SnapshotPtr &operator=(const SnapshotPtr &) = delete;
+
+        SnapshotPtr &operator=(SnapshotPtr &&other) noexcept {
+            if (this != &other) {
+                guarded_ = std::move(other.guarded_);
+                value_ = std::exchange(other.value_, nullptr);
+            }
+            return *this;
+        }
+
+        element_type *get() const {
+            return value_;
+        }
+
+        element_type &operator*() const {
+            return *value_;
+        }
+
+        element_type *operator->() const {
+            return value_;
+        }
+
+        explicit operator bool() const {
+            return value_ != nullptr;
+        }
+
+        // the atomic's reference to the block cannot be dropped while the hazard pointer is set
+        SharedPtr<TValue> promote() {
+            ControlBlockBase *control_block = guarded_.get();
+            if (control_block == nullptr) {
+                return SharedPtr<TValue>{};
+            }
+            control_block->incrementRef();
+            return SharedPtr<TValue>(control_block);
+        }
+
+    private:
+        explicit SnapshotPtr(GuardedPtr guarded)
+            : guarded_(std::move(guarded)),
+              value_(guarded_ ? reinterpret_cast<element_type *>(guarded_->get()) : nullptr) {}
+
+        ControlBlockBase *controlBlock() {
+            return guarded_.get();
+        }
+
+    private:
+        GuardedPtr guarded_;
+        element_type *value_{nullptr};
+    };
+
     template <class TValue, class Reclaimer>
     class AtomicSharedPtr {
+        template <class TTValue, class TReclaimer>
+        friend class CachedReader;
+
+        template <class TTValue, class TReclaimer>
+        friend class CasEntry;
+
         using InternalReclaimer = ReclaimerTraits<Reclaimer>;
+        using GuardedPtr = typename InternalReclaimer::GuardedPtr;
+        using Mcas = MultiWordCas<Reclaimer>;
 
     public:
+        using Snapshot = SnapshotPtr<TValue, Reclaimer>;
+
         static constexpr bool is_always_lock_free = true;
 
     public:
@@ -621,15 +1454,15 @@ namespace lu::detail {
         }
 
         void store(SharedPtr<TValue> ptr, std::memory_order order = std::memory_order_seq_cst) {
-            ControlBlockBase *new_ptr = ptr.release();
-            ControlBlockBase *old_ptr = control_block_.exchange(new_ptr, order);
+            ptr.unalias();
+            ControlBlockBase *old_ptr = replace(ptr.release(), order);
             if (old_ptr != nullptr) {
                 InternalReclaimer::delayDecrementRef(old_ptr);
             }
         }
 
-        SharedPtr<TValue> load() const {
-            auto guarded = InternalReclaimer::protect(control_block_);
+        SharedPtr<TValue> load(std::memory_order order = std::memory_order_seq_cst) const {
+            GuardedPtr guarded = protectValue(order);
             if (guarded.get() == nullptr) {
                 return SharedPtr<TValue>{};
             } else {
@@ -638,34 +1471,248 @@ namespace lu::detail {
             }
         }
 
+        Snapshot snapshot(std::memory_order order = std::memory_order_seq_cst) const {
+            return Snapshot(protectValue(order));
+        }
+
+        // calls fn with a pointer to the current value (or nullptr) that stays valid for the duration of the call
+        template <class Fn>
+        decltype(auto) read(Fn &&fn, std::memory_order order = std::memory_order_seq_cst) const {
+            Snapshot current = snapshot(order);
+            return std::forward<Fn>(fn)(static_cast<const typename Snapshot::element_type *>(current.get()));
+        }
+
+        // RCU style update: fn gets the current value (or nullptr) and returns its replacement, which is published
+        // only if the atomic still stores the value fn has seen, otherwise fn runs again on the newer value
+        template <class Fn>
+        SharedPtr<TValue> update(Fn &&fn, std::memory_order order = std::memory_order_seq_cst) {
+            Backoff backoff;
+            Snapshot current = snapshot(failureOrder(order));
+            while (true) {
+                SharedPtr<TValue> desired = fn(static_cast<const typename Snapshot::element_type *>(current.get()));
+                if (compareExchange(current, desired, order)) {
+                    return desired;
+                }
+                backoff.pause();
+            }
+        }
+
+        // a single attempt of update(), returns false if the atomic was changed concurrently
+        template <class Fn>
+        bool tryUpdate(Fn &&fn, std::memory_order order = std::memory_order_seq_cst) {
+            Snapshot current = snapshot(failureOrder(order));
+            SharedPtr<TValue> desired = fn(static_cast<const typename Snapshot::element_type *>(current.get()));
+            return compareExchange(current, std::move(desired), order);
+        }
+
+        // blocks until the atomic no longer stores old, stores do not notify by themselves
+        void wait(const SharedPtr<TValue> &old, std::memory_order order = std::memory_order_seq_cst) const {
+            if (!old.isAliased()) {
+                ControlBlockBase *old_ptr = old.control_block_;
+                ParkingLot::of(&control_block_).waitUntil([&] { return loadPointer(order) != old_ptr; });
+                return;
+            }
+            ParkingLot::of(&control_block_).waitUntil([&] {
+                GuardedPtr guarded = protectValue(order);
+                return !stands(guarded.get(), old);
+            });
+        }
+
+        void notifyOne() const {
+            ParkingLot::of(&control_block_).notifyOne();
+        }
+
+        void notifyAll() const {
+            ParkingLot::of(&control_block_).notifyAll();
+        }
+
         SharedPtr<TValue> exchange(SharedPtr<TValue> ptr, std::memory_order order = std::memory_order_seq_cst) {
-            ControlBlockBase *new_ptr = ptr.release();
-            ControlBlockBase *old_ptr = control_block_.exchange(new_ptr, order);
+            ptr.unalias();
+            ControlBlockBase *old_ptr = replace(ptr.release(), order);
+            if (old_ptr == nullptr) {
+                return SharedPtr<TValue>();
+            }
+            // a reader may still protect the old block, its reference of the atomic goes through the reclaimer
+            old_ptr->incrementRef();
+            InternalReclaimer::delayDecrementRef(old_ptr);
             return SharedPtr<TValue>(old_ptr);
         }
 
         bool compareExchange(SharedPtr<TValue> &expected, SharedPtr<TValue> desired) {
+            return compareExchangeStrong(expected, std::move(desired));
+        }
+
+        // on failure expected is re-protected at the current value, no reference is taken for it
+        bool compareExchange(Snapshot &expected, const SharedPtr<TValue> &desired,
+                             std::memory_order order = std::memory_order_seq_cst) {
+            if (desired.isAliased()) {
+                return compareExchange(expected, SharedPtr<TValue>(desired), order);
+            }
+            ControlBlockBase *desired_ptr = desired.control_block_;
+            if (desired_ptr != nullptr) {
+                // taken before publishing, a concurrent replacement may give the reference back right after the CAS
+                desired_ptr->incrementRef();
+            }
+            if (compareExchangeSnapshot(expected, desired_ptr, order)) {
+                return true;
+            }
+            if (desired_ptr != nullptr) {
+                desired_ptr->decrementRef();
+            }
+            return false;
+        }
+
+        bool compareExchange(Snapshot &expected, SharedPtr<TValue> &&desired,
+                             std::memory_order order = std::memory_order_seq_cst) {
+            desired.unalias();
+            if (compareExchangeSnapshot(expected, desired.control_block_, order)) {
+                desired.release();
+                return true;
+            }
+            return false;
+        }
+
+        bool compareExchangeWeak(SharedPtr<TValue> &expected, SharedPtr<TValue> desired, std::memory_order success,
+                                 std::memory_order failure) {
+            return compareExchangeImpl<true>(expected, std::move(desired), success, failure);
+        }
+
+        bool compareExchangeWeak(SharedPtr<TValue> &expected, SharedPtr<TValue> desired,
+                                 std::memory_order order = std::memory_order_seq_cst) {
+            return compareExchangeImpl<true>(expected, std::move(desired), order, failureOrder(order));
+        }
+
+        bool compareExchangeStrong(SharedPtr<TValue> &expected, SharedPtr<TValue> desired, std::memory_order success,
+                                   std::memory_order failure) {
+            return compareExchangeImpl<false>(expected, std::move(desired), success, failure);
+        }
+
+        bool compareExchangeStrong(SharedPtr<TValue> &expected, SharedPtr<TValue> desired,
+                                   std::memory_order order = std::memory_order_seq_cst) {
+            return compareExchangeImpl<false>(expected, std::move(desired), order, failureOrder(order));
+        }
+
+    private:
+        template <bool Weak>
+        bool compareExchangeImpl(SharedPtr<TValue> &expected, SharedPtr<TValue> desired, std::memory_order success,
+                                 std::memory_order failure) {
+            desired.unalias();
             ControlBlockBase *expected_ptr = expected.control_block_;
             ControlBlockBase *desired_ptr = desired.control_block_;
-            if (control_block_.compare_exchange_strong(expected_ptr, desired_ptr)) {
+            bool exchanged;
+            if (!expected.isAliased()) {
+                while (true) {
+                    exchanged = Weak ? control_block_.compare_exchange_weak(expected_ptr, desired_ptr, success, failure)
+                                     : control_block_.compare_exchange_strong(expected_ptr, desired_ptr, success,
+                                                                              failure);
+                    if (exchanged || Weak || !Mcas::isDescriptor(expected_ptr)) {
+                        break;
+                    }
+                    // the value behind a multi-word CAS in progress may still be the expected one
+                    Mcas::helpWord(control_block_);
+                    expected_ptr = expected.control_block_;
+                }
+            } else {
+                // the atomic stores an alias block of its own, the guard keeps it from being reused until the CAS
+                while (true) {
+                    GuardedPtr guarded = protectValue(failure);
+                    if (!stands(guarded.get(), expected)) {
+                        exchanged = false;
+                        break;
+                    }
+                    expected_ptr = guarded.get();
+                    exchanged = control_block_.compare_exchange_strong(expected_ptr, desired_ptr, success, failure);
+                    if (exchanged || Weak) {
+                        break;
+                    }
+                }
+            }
+            if (exchanged) {
                 if (expected_ptr != nullptr) {
                     InternalReclaimer::delayDecrementRef(expected_ptr);
                 }
                 desired.release();
                 return true;
             } else {
-                expected = std::move(load());
+                expected = std::move(load(failure));
                 return false;
             }
         }
 
+        bool compareExchangeSnapshot(Snapshot &expected, ControlBlockBase *desired_ptr, std::memory_order order) {
+            ControlBlockBase *expected_ptr = expected.controlBlock();
+            while (!control_block_.compare_exchange_strong(expected_ptr, desired_ptr, order, failureOrder(order))) {
+                if (!Mcas::isDescriptor(expected_ptr)) {
+                    expected = snapshot(failureOrder(order));
+                    return false;
+                }
+                Mcas::helpWord(control_block_);
+                expected_ptr = expected.controlBlock();
+            }
+            if (expected_ptr != nullptr) {
+                InternalReclaimer::delayDecrementRef(expected_ptr);
+            }
+            return true;
+        }
+
+        // the word may hold the descriptor of a multi-word CAS, which is helped to its end before reading again
+        GuardedPtr protectValue(std::memory_order order) const {
+            while (true) {
+                uintptr_t tag;
+                GuardedPtr guarded = InternalReclaimer::protectTagged(control_block_, Mcas::kMask, tag, order);
+                if (tag == 0) {
+                    return guarded;
+                }
+                guarded.clear();
+                Mcas::helpWord(control_block_);
+            }
+        }
+
+        // the stored control block without a reference, a multi-word CAS in progress is helped to its end since
+        // its descriptor stands for either of two values
+        ControlBlockBase *loadPointer(std::memory_order order) const {
+            ControlBlockBase *ptr = control_block_.load(order);
+            while (Mcas::isDescriptor(ptr)) {
+                Mcas::helpWord(control_block_);
+                ptr = control_block_.load(order);
+            }
+            return ptr;
+        }
+
+        // a plain exchange could overwrite a multi-word CAS in progress
+        ControlBlockBase *replace(ControlBlockBase *new_ptr, std::memory_order order) {
+            ControlBlockBase *old_ptr = control_block_.load(std::memory_order_relaxed);
+            while (true) {
+                if (Mcas::isDescriptor(old_ptr)) {
+                    Mcas::helpWord(control_block_);
+                    old_ptr = control_block_.load(std::memory_order_relaxed);
+                } else if (control_block_.compare_exchange_weak(old_ptr, new_ptr, order, std::memory_order_relaxed)) {
+                    return old_ptr;
+                }
+            }
+        }
+
+        bool holds(const SharedPtr<TValue> &ptr) const {
+            return loadPointer(std::memory_order_acquire) == ptr.control_block_;
+        }
+
+        // whether a protected alias block stands for the aliased pointer
+        static bool stands(ControlBlockBase *ptr, const SharedPtr<TValue> &aliased) {
+            return ptr != nullptr && ptr->owner() == aliased.control_block_ &&
+                   ptr->get() == const_cast<void *>(static_cast<const volatile void *>(aliased.value_));
+        }
+
     private:
-        std::atomic<ControlBlockBase *> control_block_;
+        mutable std::atomic<ControlBlockBase *> control_block_;
     };
 
     template <class TValue, class Reclaimer>
     class AtomicWeakPtr {
         using InternalReclaimer = ReclaimerTraits<Reclaimer>;
+        using element_type = typename WeakPtr<TValue>::element_type;
+
+        // an aliased weak pointer is stored as a WeakAliasControlBlock tagged with kAliasTag
+        static constexpr uintptr_t kAliasTag = 1;
 
     public:
         static constexpr bool is_always_lock_free = true;
@@ -678,7 +1725,7 @@ namespace lu::detail {
         AtomicWeakPtr(AtomicWeakPtr &&) = delete;
 
         ~AtomicWeakPtr() {
-            auto ptr = control_block_.load();
+            auto ptr = pointer(control_block_.load());
             if (ptr != nullptr) {
                 ptr->decrementWeakRef();
             }
@@ -698,47 +1745,248 @@ namespace lu::detail {
         }
 
         void store(WeakPtr<TValue> ptr, std::memory_order order = std::memory_order_seq_cst) {
-            ControlBlockBase *new_ptr = ptr.release();
-            ControlBlockBase *old_ptr = control_block_.exchange(new_ptr, order);
+            ControlBlockBase *old_ptr = pointer(control_block_.exchange(toWord(std::move(ptr)), order));
             if (old_ptr != nullptr) {
                 InternalReclaimer::delayDecrementWeakRef(old_ptr);
             }
         }
 
-        WeakPtr<TValue> load() const {
-            auto guarded = InternalReclaimer::protect(control_block_);
+        WeakPtr<TValue> load(std::memory_order order = std::memory_order_seq_cst) const {
+            uintptr_t tag;
+            auto guarded = InternalReclaimer::protectTagged(control_block_, kAliasTag, tag, order);
             if (guarded.get() == nullptr) {
                 return WeakPtr<TValue>{};
-            } else {
-                guarded->incrementWeakRef();
-                return WeakPtr<TValue>(guarded.get());
             }
+            ControlBlockBase *owner = ownerOf(guarded.get(), tag);
+            owner->incrementWeakRef();
+            return WeakPtr<TValue>(owner, valueOf(guarded.get()));
+        }
+
+        // load().lock() without the temporary weak reference, the hazard pointer keeps the control block alive
+        SharedPtr<TValue> lock(std::memory_order order = std::memory_order_seq_cst) const {
+            SharedPtr<TValue> result;
+            tryLoadStrong(result, order);
+            return result;
+        }
+
+        // returns false and leaves result as it is if the atomic is empty or the object has expired
+        bool tryLoadStrong(SharedPtr<TValue> &result, std::memory_order order = std::memory_order_seq_cst) const {
+            uintptr_t tag;
+            auto guarded = InternalReclaimer::protectTagged(control_block_, kAliasTag, tag, order);
+            if (guarded.get() == nullptr) {
+                return false;
+            }
+            ControlBlockBase *owner = ownerOf(guarded.get(), tag);
+            if (!owner->incrementNotZeroRef()) {
+                return false;
+            }
+            result = SharedPtr<TValue>(owner, valueOf(guarded.get()));
+            return true;
         }
 
         WeakPtr<TValue> exchange(WeakPtr<TValue> ptr, std::memory_order order = std::memory_order_seq_cst) {
-            ControlBlockBase *new_ptr = ptr.release();
-            ControlBlockBase *old_ptr = control_block_.exchange(new_ptr, order);
-            return WeakPtr<TValue>(old_ptr);
+            ControlBlockBase *old_word = control_block_.exchange(toWord(std::move(ptr)), order);
+            ControlBlockBase *old_ptr = pointer(old_word);
+            if (old_ptr == nullptr) {
+                return WeakPtr<TValue>();
+            }
+            // the old block may still be protected by a reader
+            if (!isAlias(old_word)) {
+                old_ptr->incrementWeakRef();
+                InternalReclaimer::delayDecrementWeakRef(old_ptr);
+                return WeakPtr<TValue>(old_ptr);
+            }
+            ControlBlockBase *owner = static_cast<WeakAliasControlBlock *>(old_ptr)->owner();
+            owner->incrementWeakRef();
+            WeakPtr<TValue> result(owner, valueOf(old_ptr));
+            InternalReclaimer::delayDecrementWeakRef(old_ptr);
+            return result;
         }
 
         bool compareExchange(WeakPtr<TValue> &expected, WeakPtr<TValue> desired) {
-            ControlBlockBase *expected_ptr = expected.control_block_;
-            ControlBlockBase *desired_ptr = desired.control_block_;
-            if (control_block_.compare_exchange_strong(expected_ptr, desired_ptr)) {
-                if (expected_ptr != nullptr) {
-                    InternalReclaimer::delayDecrementWeakRef(expected_ptr);
+            return compareExchangeStrong(expected, std::move(desired));
+        }
+
+        // blocks until the atomic no longer stores old, stores do not notify by themselves
+        void wait(const WeakPtr<TValue> &old, std::memory_order order = std::memory_order_seq_cst) const {
+            if (!old.isAliased()) {
+                ControlBlockBase *old_ptr = old.control_block_;
+                ParkingLot::of(&control_block_).waitUntil([&] { return control_block_.load(order) != old_ptr; });
+                return;
+            }
+            ParkingLot::of(&control_block_).waitUntil([&] {
+                uintptr_t tag;
+                auto guarded = InternalReclaimer::protectTagged(control_block_, kAliasTag, tag, order);
+                return !stands(guarded.get(), tag, old);
+            });
+        }
+
+        void notifyOne() const {
+            ParkingLot::of(&control_block_).notifyOne();
+        }
+
+        void notifyAll() const {
+            ParkingLot::of(&control_block_).notifyAll();
+        }
+
+        bool compareExchangeWeak(WeakPtr<TValue> &expected, WeakPtr<TValue> desired, std::memory_order success,
+                                 std::memory_order failure) {
+            return compareExchangeImpl<true>(expected, std::move(desired), success, failure);
+        }
+
+        bool compareExchangeWeak(WeakPtr<TValue> &expected, WeakPtr<TValue> desired,
+                                 std::memory_order order = std::memory_order_seq_cst) {
+            return compareExchangeImpl<true>(expected, std::move(desired), order, failureOrder(order));
+        }
+
+        bool compareExchangeStrong(WeakPtr<TValue> &expected, WeakPtr<TValue> desired, std::memory_order success,
+                                   std::memory_order failure) {
+            return compareExchangeImpl<false>(expected, std::move(desired), success, failure);
+        }
+
+        bool compareExchangeStrong(WeakPtr<TValue> &expected, WeakPtr<TValue> desired,
+                                   std::memory_order order = std::memory_order_seq_cst) {
+            return compareExchangeImpl<false>(expected, std::move(desired), order, failureOrder(order));
+        }
+
+    private:
+        template <bool Weak>
+        bool compareExchangeImpl(WeakPtr<TValue> &expected, WeakPtr<TValue> desired, std::memory_order success,
+                                 std::memory_order failure) {
+            ControlBlockBase *desired_word = toWord(std::move(desired));
+            bool exchanged;
+            ControlBlockBase *expected_word = expected.control_block_;
+            if (!expected.isAliased()) {
+                exchanged = Weak ? control_block_.compare_exchange_weak(expected_word, desired_word, success, failure)
+                                 : control_block_.compare_exchange_strong(expected_word, desired_word, success,
+                                                                          failure);
+            } else {
+                // the atomic stores an alias block of its own, the guard keeps it from being reused until the CAS
+                while (true) {
+                    uintptr_t tag;
+                    auto guarded = InternalReclaimer::protectTagged(control_block_, kAliasTag, tag, failure);
+                    if (!stands(guarded.get(), tag, expected)) {
+                        exchanged = false;
+                        break;
+                    }
+                    expected_word = tagged(guarded.get());
+                    exchanged = control_block_.compare_exchange_strong(expected_word, desired_word, success, failure);
+                    if (exchanged || Weak) {
+                        break;
+                    }
+                }
+            }
+            if (exchanged) {
+                if (expected_word != nullptr) {
+                    InternalReclaimer::delayDecrementWeakRef(pointer(expected_word));
                 }
-                desired.release();
                 return true;
-            } else {
-                expected = std::move(load());
-                return false;
             }
+            // the desired word was never published
+            if (desired_word != nullptr) {
+                pointer(desired_word)->decrementWeakRef();
+            }
+            expected = std::move(load(failure));
+            return false;
+        }
+
+        // takes over the reference of ptr
+        static ControlBlockBase *toWord(WeakPtr<TValue> &&ptr) {
+            if (!ptr.isAliased()) {
+                return ptr.release();
+            }
+            void *value = const_cast<void *>(static_cast<const volatile void *>(ptr.value_));
+            return tagged(WeakAliasControlBlock::create(ptr.release(), value));
+        }
+
+        static bool isAlias(ControlBlockBase *word) {
+            return reinterpret_cast<uintptr_t>(word) & kAliasTag;
+        }
+
+        static ControlBlockBase *pointer(ControlBlockBase *word) {
+            return reinterpret_cast<ControlBlockBase *>(reinterpret_cast<uintptr_t>(word) & ~kAliasTag);
+        }
+
+        static ControlBlockBase *tagged(ControlBlockBase *alias) {
+            return reinterpret_cast<ControlBlockBase *>(reinterpret_cast<uintptr_t>(alias) | kAliasTag);
+        }
+
+        // the control block a protected pointer loaded with tag stands for
+        static ControlBlockBase *ownerOf(ControlBlockBase *ptr, uintptr_t tag) {
+            return tag != 0 ? static_cast<WeakAliasControlBlock *>(ptr)->owner() : ptr;
+        }
+
+        static element_type *valueOf(ControlBlockBase *ptr) {
+            return reinterpret_cast<element_type *>(ptr->get());
+        }
+
+        // whether a protected alias block stands for the aliased weak pointer
+        static bool stands(ControlBlockBase *ptr, uintptr_t tag, const WeakPtr<TValue> &weak) {
+            return tag != 0 && ownerOf(ptr, tag) == weak.control_block_ &&
+                   ptr->get() == const_cast<void *>(static_cast<const volatile void *>(weak.value_));
         }
 
     private:
         std::atomic<ControlBlockBase *> control_block_;
     };
+
+    // One word of compareExchangeMulti(): the atomic, the value it is expected to store and its replacement.
+    template <class TValue, class Reclaimer>
+    class CasEntry {
+        template <class TReclaimer, class... TValues>
+        friend bool compareExchangeMulti(CasEntry<TValues, TReclaimer>... entries);
+
+    public:
+        CasEntry(AtomicSharedPtr<TValue, Reclaimer> &target, const SharedPtr<TValue> &expected,
+                 SharedPtr<TValue> desired)
+            : word_(&target.control_block_), expected_(expected.control_block_) {
+            desired.unalias();
+            desired_ = desired.release();
+        }
+
+        CasEntry(const CasEntry &) = delete;
+
+        CasEntry(CasEntry &&other) noexcept
+            : word_(other.word_), expected_(other.expected_), desired_(std::exchange(other.desired_, nullptr)) {}
+
+        ~CasEntry() {
+            if (desired_ != nullptr) {
+                desired_->decrementRef();
+            }
+        }
+
+        CasEntry &operator=(const CasEntry &) = delete;
+
+        CasEntry &operator=(CasEntry &&) = delete;
+
+    private:
+        ControlBlockWord *word_;
+        ControlBlockBase *expected_;
+        ControlBlockBase *desired_;
+    };
+
+    // Replaces the values of all atomics at once if every one of them stores its expected control block,
+    // otherwise changes nothing. The atomics have to be distinct.
+    template <class Reclaimer, class... TValues>
+    bool compareExchangeMulti(CasEntry<TValues, Reclaimer>... entries) {
+        static_assert(sizeof...(TValues) <= McasDescriptor::kMaxWords, "Too many words");
+        using Mcas = MultiWordCas<Reclaimer>;
+        auto *descriptor = new McasDescriptor();
+        ((descriptor->entries[descriptor->size++] = {entries.word_, entries.expected_, entries.desired_}), ...);
+        bool succeeded = Mcas::run(descriptor);
+        if (succeeded) {
+            // the references to the desired values now belong to the atomics
+            ((entries.desired_ = nullptr), ...);
+            for (size_t i = 0; i < descriptor->size; ++i) {
+                ControlBlockBase *replaced = descriptor->entries[i].expected;
+                if (replaced != nullptr) {
+                    ReclaimerTraits<Reclaimer>::delayDecrementRef(replaced);
+                }
+            }
+        }
+        Mcas::retire(descriptor);
+        return succeeded;
+    }
 }// namespace lu::detail
 
 
@@ -0,0 +1,86 @@
+//
+// Created by ludaludaed on 18.10.2026.
+//
+
+#ifndef ATOMIC_SHARED_POINTER_ATOMIC_UNIQUE_POINTER_H
+#define ATOMIC_SHARED_POINTER_ATOMIC_UNIQUE_POINTER_H
+
+#include "utils.h"
+#include <atomic>
+#include <memory>
+
+namespace lu::detail {
+    // Atomic slot that solely owns its object, there is no control block and no reference count. Readers get a
+    // hazard protected pointer, a replaced object is retired to the domain and deleted once no reader protects it.
+    template <class TValue, class Reclaimer>
+    class AtomicUniquePtr {
+    public:
+        using GuardedPtr = typename Reclaimer::template GuardedPtr<TValue>;
+
+        static constexpr bool is_always_lock_free = true;
+
+    public:
+        AtomicUniquePtr() : ptr_(nullptr) {}
+
+        explicit AtomicUniquePtr(std::unique_ptr<TValue> value) : ptr_(value.release()) {}
+
+        AtomicUniquePtr(const AtomicUniquePtr &) = delete;
+
+        AtomicUniquePtr(AtomicUniquePtr &&) = delete;
+
+        ~AtomicUniquePtr() {
+            delete ptr_.load();
+        }
+
+        AtomicUniquePtr &operator=(const AtomicUniquePtr &) = delete;
+
+        AtomicUniquePtr &operator=(AtomicUniquePtr &&) = delete;
+
+        AtomicUniquePtr &operator=(std::unique_ptr<TValue> other) {
+            store(std::move(other));
+            return *this;
+        }
+
+        [[nodiscard]] bool is_lock_free() const noexcept {
+            return true;
+        }
+
+        void store(std::unique_ptr<TValue> value, std::memory_order order = std::memory_order_seq_cst) {
+            TValue *old_ptr = ptr_.exchange(value.release(), order);
+            if (old_ptr != nullptr) {
+                retire(old_ptr);
+            }
+        }
+
+        GuardedPtr load(std::memory_order order = std::memory_order_seq_cst) const {
+            return reclaimer.protect(ptr_, order);
+        }
+
+        // the old object is retired as well, the result keeps it readable until dropped
+        GuardedPtr exchange(std::unique_ptr<TValue> value, std::memory_order order = std::memory_order_seq_cst) {
+            TValue *old_ptr = ptr_.exchange(value.release(), order);
+            if (old_ptr == nullptr) {
+                return GuardedPtr{};
+            }
+            GuardedPtr result = reclaimer.guard(old_ptr);
+            retire(old_ptr);
+            return result;
+        }
+
+        void reset() {
+            store(nullptr);
+        }
+
+    private:
+        static void retire(TValue *ptr) {
+            reclaimer.template retire<DefaultDeleter>(ptr);
+        }
+
+    private:
+        static inline Reclaimer &reclaimer = Reclaimer::instance();
+
+        std::atomic<TValue *> ptr_;
+    };
+}// namespace lu::detail
+
+#endif//ATOMIC_SHARED_POINTER_ATOMIC_UNIQUE_POINTER_H
@@ -0,0 +1,340 @@
+//
+// Created by ludaludaed on 18.10.2026.
+//
+
+#ifndef ATOMIC_SHARED_POINTER_BIASED_REF_COUNT_H
+#define ATOMIC_SHARED_POINTER_BIASED_REF_COUNT_H
+
+#include "sticky_counter.h"
+#include "thread_entry_list.h"
+#include "utils.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace lu::detail {
+    // Biased reference counting. The thread that created the counter (its owner) counts its references in a
+    // non-atomic biased counter, every other thread uses the atomic shared counter. The total is biased + shared,
+    // so the shared counter alone may become negative; the thread that makes it negative queues the counter to
+    // the owner, which merges both counters later. Once the biased counter drops to zero the counters are merged
+    // for good and the shared counter runs as a StickyCounter: dropping to zero sets a flag no increment can revive.
+    // Before the merge the same word counts the shared references by the rules below, kMergedFlag hands it over.
+    // Increments are relaxed, a reference is only ever taken from one the caller already holds or from a count the
+    // read-modify-write sees in full. Decrements release, and whoever observes zero acquires before releasing.
+    // The owner merges queued counters on its releases and allocations, so an owner that only allocates and hands
+    // the objects off does not hold them back. Objects an allocation releases are not destroyed inside it, they are
+    // left to the next release on any thread.
+    // A release on another thread thus waits for the owner, so a counter starts merged and only bias() makes the
+    // calling thread its owner; callers opt in per object for objects their creating thread keeps using.
+    class BiasedRefCount {
+        struct OwnerData {
+            std::atomic<BiasedRefCount *> queue{nullptr};
+        };
+
+        using OwnerList = ThreadEntryList<OwnerData>;
+        using Owner = typename OwnerList::Entry;
+
+        struct OwnerGuard {
+            ~OwnerGuard() {
+                Owner *owner = current_owner_;
+                current_owner_ = nullptr;
+                owner_released_ = true;
+                if (owner != nullptr) {
+                    drain(owner);
+                    owner->release();
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    help(owner);
+                }
+            }
+        };
+
+        static constexpr uintptr_t kZeroFlag = StickyCounter::kZeroFlag;
+        static constexpr uintptr_t kMergedFlag = 4;
+        static constexpr uintptr_t kQueuedFlag = 8;
+        static constexpr uintptr_t kOne = StickyCounter::kOne;
+
+        static_assert(kQueuedFlag < kOne, "State flags must fit below the count");
+
+    protected:
+        BiasedRefCount() {
+            Owner *owner = current_owner_;
+            if (owner != nullptr && owner->value().queue.load(std::memory_order_relaxed) != nullptr) {
+                drain(owner, true);
+            }
+        }
+
+        virtual ~BiasedRefCount() = default;
+
+        // moves the single reference of a counter nobody else has seen yet to the biased counter of this thread
+        void bias() {
+            Owner *owner = acquireOwner();
+            if (owner == nullptr) {
+                return;
+            }
+            owner_.store(owner, std::memory_order_relaxed);
+            biased_.store(1, std::memory_order_relaxed);
+            shared_.word().store(0, std::memory_order_relaxed);
+            if (owner->value().queue.load(std::memory_order_relaxed) != nullptr) {
+                drain(owner, true);
+            }
+        }
+
+        // only if the caller already holds a reference
+        void incrementStrong(size_t num) {
+            if (isOwner()) {
+                biased_.store(biased_.load(std::memory_order_relaxed) + num, std::memory_order_relaxed);
+            } else {
+                shared_.increment(num);
+            }
+        }
+
+        // the total of an unmerged counter may be zero while the release waits for the owner, nobody can raise it
+        // again then, so the upgrade checks the total first
+        bool incrementStrongNotZero(size_t num) {
+            if (isOwner()) {
+                // the shared count only drops while another thread holds a reference
+                size_t biased = biased_.load(std::memory_order_relaxed);
+                if (static_cast<intptr_t>(biased) + count(shared_.word().load(std::memory_order_acquire)) <= 0) {
+                    return false;
+                }
+                biased_.store(biased + num, std::memory_order_relaxed);
+                return true;
+            }
+            std::atomic<uintptr_t> &shared = shared_.word();
+            uintptr_t value = shared.load(std::memory_order_relaxed);
+            while (!(value & kMergedFlag)) {
+                size_t biased = biased_.load(std::memory_order_seq_cst);
+                if (count(value) + static_cast<intptr_t>(biased) <= 0) {
+                    return false;
+                }
+                if (!shared.compare_exchange_weak(value, value + num * kOne, std::memory_order_seq_cst,
+                                                  std::memory_order_relaxed)) {
+                    continue;
+                }
+                // a biased count that did not move means the total was not zero at the CAS, since a zero total
+                // leaves the owner without references to count up again
+                if (biased_.load(std::memory_order_seq_cst) == biased) {
+                    return true;
+                }
+                if (decrementShared(num)) {
+                    releaseStrong();
+                }
+                value = shared.load(std::memory_order_relaxed);
+            }
+            // a merged counter that is still queued holds a zero count without the flag until the owner dequeues it
+            while (value & kQueuedFlag) {
+                if ((value & kZeroFlag) || count(value) <= 0) {
+                    return false;
+                }
+                if (shared.compare_exchange_weak(value, value + num * kOne, std::memory_order_relaxed,
+                                                 std::memory_order_relaxed)) {
+                    return true;
+                }
+            }
+            return shared_.incrementNotZero(num);
+        }
+
+        // only on the owner thread while it holds a biased reference, no thread lookup is made then
+        void incrementBiased(size_t num) {
+            size_t biased = biased_.load(std::memory_order_relaxed);
+            if (biased != 0) {
+                biased_.store(biased + num, std::memory_order_relaxed);
+            } else {
+                incrementStrong(num);
+            }
+        }
+
+        bool decrementBiased(size_t num) {
+            size_t biased = biased_.load(std::memory_order_relaxed);
+            if (biased != 0) {
+                biased_.store(biased - num, std::memory_order_relaxed);
+                return biased == num && mergeZeroBiased();
+            }
+            return decrementStrong(num);
+        }
+
+        // returns true if the last reference is gone and the caller has to release the object
+        bool decrementStrong(size_t num) {
+            bool released;
+            if (isOwner()) {
+                size_t biased = biased_.load(std::memory_order_relaxed) - num;
+                biased_.store(biased, std::memory_order_relaxed);
+                released = biased == 0 && mergeZeroBiased();
+            } else {
+                released = decrementShared(num);
+            }
+            Owner *owner = current_owner_;
+            if (owner != nullptr && owner->value().queue.load(std::memory_order_relaxed) != nullptr) {
+                drain(owner);
+            }
+            if (orphans_.load(std::memory_order_relaxed) != nullptr) {
+                releaseOrphans();
+            }
+            return released;
+        }
+
+        size_t loadStrong() const {
+            uintptr_t value = shared_.word().load(std::memory_order_relaxed);
+            if (!(value & kMergedFlag)) {
+                return static_cast<size_t>(count(value) + static_cast<intptr_t>(biased_.load(std::memory_order_relaxed)));
+            }
+            return shared_.load();
+        }
+
+        virtual void releaseStrong() = 0;
+
+    private:
+        static intptr_t count(uintptr_t value) {
+            return StickyCounter::count(value);
+        }
+
+        static uintptr_t withCount(uintptr_t value, intptr_t count) {
+            return StickyCounter::withCount(value, count);
+        }
+
+        // the owner entry is never reset, a zero biased counter tells that the counters are merged
+        bool isOwner() const {
+            Owner *owner = current_owner_;
+            return owner != nullptr && owner_.load(std::memory_order_relaxed) == owner &&
+                   biased_.load(std::memory_order_relaxed) != 0;
+        }
+
+        bool decrementShared(size_t num) {
+            Owner *owner = owner_.load(std::memory_order_relaxed);
+            std::atomic<uintptr_t> &shared = shared_.word();
+            uintptr_t value = shared.load(std::memory_order_relaxed);
+            while (!(value & kMergedFlag)) {
+                uintptr_t new_value = value - num * kOne;
+                if (count(new_value) < 0) {
+                    new_value |= kQueuedFlag;
+                }
+                if (shared.compare_exchange_weak(value, new_value, std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+                    if ((new_value & kQueuedFlag) && !(value & kQueuedFlag)) {
+                        enqueue(owner, this);
+                    }
+                    return false;
+                }
+            }
+            // a queued counter misses the state and is released by the owner when it is dequeued
+            return shared_.decrement(num, kMergedFlag);
+        }
+
+        // called by the owner when its biased counter dropped to zero
+        bool mergeZeroBiased() {
+            std::atomic<uintptr_t> &shared = shared_.word();
+            uintptr_t value = shared.load(std::memory_order_relaxed);
+            uintptr_t new_value;
+            do {
+                new_value = value | kMergedFlag;
+                if (!(value & kQueuedFlag) && count(value) == 0) {
+                    new_value |= kZeroFlag;
+                }
+            } while (!shared.compare_exchange_weak(value, new_value, std::memory_order_acq_rel,
+                                                   std::memory_order_relaxed));
+            return new_value & kZeroFlag;
+        }
+
+        // called by the holder of the owner entry for a dequeued counter, nothing may touch the counter
+        // after the last CAS since a concurrent decrement can release it right away
+        bool mergeQueued() {
+            auto biased = static_cast<intptr_t>(biased_.load(std::memory_order_relaxed));
+            biased_.store(0, std::memory_order_relaxed);
+            std::atomic<uintptr_t> &shared = shared_.word();
+            uintptr_t value = shared.load(std::memory_order_relaxed);
+            uintptr_t new_value;
+            do {
+                new_value = value & ~kQueuedFlag;
+                if (!(value & kMergedFlag)) {
+                    new_value = withCount(new_value, count(value) + biased) | kMergedFlag;
+                }
+                if (count(new_value) == 0) {
+                    new_value |= kZeroFlag;
+                }
+            } while (!shared.compare_exchange_weak(value, new_value, std::memory_order_acq_rel,
+                                                   std::memory_order_relaxed));
+            return new_value & kZeroFlag;
+        }
+
+        static OwnerList &owners() {
+            // never destroyed: counters biased towards an entry may outlive static destruction
+            static OwnerList *list = new OwnerList();
+            return *list;
+        }
+
+        static Owner *acquireOwner() {
+            if (current_owner_ == nullptr && !owner_released_) {
+                thread_local OwnerGuard guard;
+                current_owner_ = owners().acquireEntry();
+            }
+            return current_owner_;
+        }
+
+        static void enqueue(Owner *owner, BiasedRefCount *counter) {
+            std::atomic<BiasedRefCount *> &queue = owner->value().queue;
+            BiasedRefCount *head = queue.load(std::memory_order_relaxed);
+            // seq_cst: pairs with the exiting owner that releases its entry and then checks the queue
+            do {
+                counter->queue_next_ = head;
+            } while (!queue.compare_exchange_weak(head, counter));
+            // the owner may have exited, then anyone can adopt its entry and merge
+            help(owner);
+        }
+
+        static void help(Owner *owner) {
+            while (owner->value().queue.load() != nullptr && owner->tryAcquire()) {
+                drain(owner);
+                owner->release();
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+
+        // with defer_release the released counters become orphans instead of being released on the spot
+        static void drain(Owner *owner, bool defer_release = false) {
+            BiasedRefCount *head;
+            while ((head = owner->value().queue.exchange(nullptr, std::memory_order_acquire)) != nullptr) {
+                while (head != nullptr) {
+                    BiasedRefCount *counter = head;
+                    head = head->queue_next_;
+                    if (!counter->mergeQueued()) {
+                        continue;
+                    }
+                    if (defer_release) {
+                        orphan(counter);
+                    } else {
+                        counter->releaseStrong();
+                    }
+                }
+            }
+        }
+
+        static void orphan(BiasedRefCount *counter) {
+            BiasedRefCount *head = orphans_.load(std::memory_order_relaxed);
+            do {
+                counter->queue_next_ = head;
+            } while (!orphans_.compare_exchange_weak(head, counter, std::memory_order_release,
+                                                     std::memory_order_relaxed));
+        }
+
+        static void releaseOrphans() {
+            BiasedRefCount *head = orphans_.exchange(nullptr, std::memory_order_acquire);
+            while (head != nullptr) {
+                BiasedRefCount *counter = head;
+                head = head->queue_next_;
+                counter->releaseStrong();
+            }
+        }
+
+    private:
+        static inline thread_local Owner *current_owner_{nullptr};
+        static inline thread_local bool owner_released_{false};
+        alignas(kCacheLineSize) static inline std::atomic<BiasedRefCount *> orphans_{nullptr};
+
+        std::atomic<Owner *> owner_{nullptr};
+        std::atomic<size_t> biased_{0};
+        StickyCounter shared_{kMergedFlag | kOne};
+        BiasedRefCount *queue_next_{nullptr};
+    };
+}// namespace lu::detail
+
+#endif//ATOMIC_SHARED_POINTER_BIASED_REF_COUNT_H
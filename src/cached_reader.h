@@ -0,0 +1,47 @@
+//
+// Created by ludaludaed on 18.10.2026.
+//
+
+#ifndef ATOMIC_SHARED_POINTER_CACHED_READER_H
+#define ATOMIC_SHARED_POINTER_CACHED_READER_H
+
+#include "atomic_shared_pointer.h"
+#include "split_ref_count.h"
+
+namespace lu::detail {
+    // Per-thread reader of a read-mostly AtomicSharedPtr. The reader keeps the last loaded value and hands it out
+    // again while the atomic still stores the same control block, so a steady-state read is a single load with
+    // no shared writes. The cached reference pins the control block, its address cannot be reused by another
+    // value and serves as the version stamp. Meant to be owned by one thread, e.g. as a thread_local.
+    template <class TValue, class Reclaimer>
+    class CachedReader {
+    public:
+        explicit CachedReader(const AtomicSharedPtr<TValue, Reclaimer> &source) : source_(source) {}
+
+        CachedReader(const CachedReader &) = delete;
+
+        CachedReader(CachedReader &&) = delete;
+
+        CachedReader &operator=(const CachedReader &) = delete;
+
+        CachedReader &operator=(CachedReader &&) = delete;
+
+        const SharedPtr<TValue> &load() {
+            if (!source_.holds(cached_)) {
+                cached_ = source_.load();
+            }
+            return cached_;
+        }
+
+        // drops the cached reference, the next load() reads the atomic again
+        void reset() {
+            cached_.reset();
+        }
+
+    private:
+        const AtomicSharedPtr<TValue, Reclaimer> &source_;
+        SharedPtr<TValue> cached_;
+    };
+}// namespace lu::detail
+
+#endif//ATOMIC_SHARED_POINTER_CACHED_READER_H
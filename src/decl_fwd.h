@@ -6,8 +6,17 @@
 #define ATOMIC_SHARED_POINTER_DECL_FWD_H
 
 #include "atomic_shared_pointer.h"
+#include "atomic_shared_group.h"
+#include "atomic_unique_pointer.h"
+#include "cached_reader.h"
+#include "futex.h"
 #include "hazard_pointer_domain.h"
+#include "markable_atomic_shared_pointer.h"
+#include "slab_allocator.h"
+#include "split_ref_count.h"
 #include "thread_entry_list.h"
+#include "update_combiner.h"
+#include "versioned_atomic_shared_pointer.h"
 
 namespace lu {
     template <size_t MaxHP = 4, size_t MaxRetired = 256, size_t ScanDelay = 8>
@@ -16,21 +25,79 @@ namespace lu {
     template <class Policy, class Allocator = std::allocator<std::byte>>
     using HazardPointers = detail::HazardPointerDomain<Policy, Allocator>;
 
+    using SplitRefCount = detail::SplitRefCount;
+
     template <class TValue, class Reclaimer = HazardPointers<HPolicy<>>>
     using AtomicSharedPtr = detail::AtomicSharedPtr<TValue, Reclaimer>;
 
     template <class TValue, class Reclaimer = HazardPointers<HPolicy<>>>
     using AtomicWeakPtr = detail::AtomicWeakPtr<TValue, Reclaimer>;
 
+    template <class TValue, class Reclaimer = HazardPointers<HPolicy<>>>
+    using MarkableAtomicSharedPtr = detail::MarkableAtomicSharedPtr<TValue, Reclaimer>;
+
+    template <class TValue, class Reclaimer = HazardPointers<HPolicy<>>>
+    using VersionedAtomicSharedPtr = detail::VersionedAtomicSharedPtr<TValue, Reclaimer>;
+
+    template <class TValue, class Reclaimer = HazardPointers<HPolicy<>>>
+    using SnapshotPtr = detail::SnapshotPtr<TValue, Reclaimer>;
+
+    template <class... TValues>
+    using AtomicSharedGroup = detail::AtomicSharedGroup<HazardPointers<HPolicy<>>, TValues...>;
+
+    template <class TValue, class Reclaimer = HazardPointers<HPolicy<>>>
+    using CachedReader = detail::CachedReader<TValue, Reclaimer>;
+
+    template <class TValue, class Reclaimer = HazardPointers<HPolicy<>>>
+    using UpdateCombiner = detail::UpdateCombiner<TValue, Reclaimer>;
+
+    template <class TValue, class Reclaimer = HazardPointers<HPolicy<>>>
+    using AtomicUniquePtr = detail::AtomicUniquePtr<TValue, Reclaimer>;
+
+    template <class TValue>
+    using SlabAllocator = detail::SlabAllocator<TValue>;
+
     template <typename TValue>
     using SharedPtr = detail::SharedPtr<TValue>;
 
     template <typename TValue>
     using WeakPtr = detail::WeakPtr<TValue>;
 
+    template <typename TValue>
+    using LocalSharedPtr = detail::LocalSharedPtr<TValue>;
+
+    template <typename TValue>
+    using EnableSharedFromThis = detail::EnableSharedFromThis<TValue>;
+
+    using detail::kSplitLayout;
+
+    using detail::kIsolatedLayout;
+
+    using detail::kBiasedCount;
+
     using detail::allocateShared;
 
     using detail::makeShared;
+
+    using detail::staticPointerCast;
+
+    using detail::dynamicPointerCast;
+
+    using detail::constPointerCast;
+
+    using detail::reinterpretPointerCast;
+
+    using detail::CasEntry;
+
+    using detail::compareExchangeMulti;
+
+    using detail::allocateLocalShared;
+
+    using detail::makeLocalShared;
+
+    using detail::setDestructionBudget;
+
+    using detail::drainPendingDestruction;
 }// namespace lu
 
 #endif//ATOMIC_SHARED_POINTER_DECL_FWD_H
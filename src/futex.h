@@ -0,0 +1,252 @@
+//
+// Created by ludaludaed on 18.10.2026.
+//
+
+#ifndef ATOMIC_SHARED_POINTER_FUTEX_H
+#define ATOMIC_SHARED_POINTER_FUTEX_H
+
+#include "utils.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <ctime>
+#endif
+
+namespace lu::detail {
+    using WaitClock = std::chrono::steady_clock;
+
+    // blocks while word holds expected, returns false once the deadline has passed; may return spuriously
+    inline bool futexWait(std::atomic<uint32_t> &word, uint32_t expected, WaitClock::time_point deadline) {
+#if defined(__linux__)
+        timespec timeout{};
+        timespec *timeout_ptr = nullptr;
+        if (deadline != WaitClock::time_point::max()) {
+            auto remaining = deadline - WaitClock::now();
+            if (remaining <= WaitClock::duration::zero()) {
+                return false;
+            }
+            auto seconds = std::chrono::duration_cast<std::chrono::seconds>(remaining);
+            auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining - seconds);
+            timeout.tv_sec = static_cast<time_t>(seconds.count());
+            timeout.tv_nsec = static_cast<long>(nanoseconds.count());
+            timeout_ptr = &timeout;
+        }
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected, timeout_ptr, nullptr, 0);
+        return deadline == WaitClock::time_point::max() || WaitClock::now() < deadline;
+#else
+        if (deadline == WaitClock::time_point::max()) {
+            word.wait(expected);
+            return true;
+        }
+        while (word.load() == expected) {
+            if (WaitClock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+#endif
+    }
+
+    inline void futexWake(std::atomic<uint32_t> &word, bool all) {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, nullptr, nullptr,
+                0);
+#else
+        if (all) {
+            word.notify_all();
+        } else {
+            word.notify_one();
+        }
+#endif
+    }
+
+    // Event count: a waiter registers itself, rechecks its condition and sleeps on the sequence word, a notifier
+    // bumps the sequence after changing the state. The notifier only touches shared words and enters the kernel
+    // when somebody is registered, so notifying without waiters is a fence and a load.
+    class EventCount {
+    public:
+        // blocks until ready() returns true, returns false if the deadline passed first
+        template <class Ready>
+        bool waitUntil(Ready &&ready, WaitClock::time_point deadline = WaitClock::time_point::max()) {
+            while (!ready()) {
+                waiters_.fetch_add(1, std::memory_order_relaxed);
+                // pairs with the fence in notify(), either the recheck sees the new state or the notifier sees us
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+                if (ready()) {
+                    waiters_.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+                bool in_time = futexWait(sequence_, sequence, deadline);
+                waiters_.fetch_sub(1, std::memory_order_relaxed);
+                if (!in_time) {
+                    return ready();
+                }
+            }
+            return true;
+        }
+
+        // the state change the waiters check has to happen before the call
+        void notifyOne() {
+            notify(false);
+        }
+
+        void notifyAll() {
+            notify(true);
+        }
+
+    private:
+        void notify(bool all) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters_.load(std::memory_order_relaxed) == 0) {
+                return;
+            }
+            sequence_.fetch_add(1);
+            futexWake(sequence_, all);
+        }
+
+    private:
+        std::atomic<uint32_t> sequence_{0};
+        std::atomic<uint32_t> waiters_{0};
+    };
+
+    // Waiters of objects without a word of their own to wait on, parked by address in a stripe the address selects.
+    // Every waiter sleeps on a word of its own, so a notification only wakes waiters of its address and notifyOne()
+    // wakes exactly one of them, the one waiting longest. Notifying an address of an empty stripe is a fence and a
+    // load; the stripe lock is only taken by waiters and by notifiers that find somebody parked.
+    class ParkingLot {
+        static constexpr size_t kStripes = 256;
+
+        struct Waiter {
+            const void *address;
+            std::atomic<uint32_t> woken{0};
+            Waiter *next{nullptr};
+        };
+
+        struct alignas(kCacheLineSize) Stripe {
+            std::mutex mutex;
+            Waiter *head{nullptr};
+            Waiter **tail{&head};
+            std::atomic<size_t> waiters{0};
+        };
+
+    public:
+        class Parking {
+            friend ParkingLot;
+
+        public:
+            // blocks until ready() returns true, returns false if the deadline passed first
+            template <class Ready>
+            bool waitUntil(Ready &&ready, WaitClock::time_point deadline = WaitClock::time_point::max()) {
+                while (!ready()) {
+                    Waiter waiter{address_};
+                    park(waiter);
+                    // pairs with the fence in notify(), either the recheck sees the new state or the notifier sees us
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    bool in_time = true;
+                    bool sleeping = !ready();
+                    while (sleeping && in_time && waiter.woken.load(std::memory_order_acquire) == 0) {
+                        in_time = futexWait(waiter.woken, 0, deadline);
+                    }
+                    // the notifier wakes under the lock, so the waiter outlives the wake
+                    if (!unpark(waiter) && !sleeping) {
+                        // a single wake that found us on the way out belongs to somebody still asleep
+                        notify(false);
+                    }
+                    if (!in_time) {
+                        return ready();
+                    }
+                }
+                return true;
+            }
+
+            // the state change the waiters check has to happen before the call
+            void notifyOne() {
+                notify(false);
+            }
+
+            void notifyAll() {
+                notify(true);
+            }
+
+        private:
+            Parking(Stripe &stripe, const void *address) : stripe_(stripe), address_(address) {}
+
+            void park(Waiter &waiter) {
+                std::lock_guard<std::mutex> lock(stripe_.mutex);
+                *stripe_.tail = &waiter;
+                stripe_.tail = &waiter.next;
+                stripe_.waiters.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            // returns false if a notifier has already taken the waiter out
+            bool unpark(Waiter &waiter) {
+                std::lock_guard<std::mutex> lock(stripe_.mutex);
+                if (waiter.woken.load(std::memory_order_relaxed) != 0) {
+                    return false;
+                }
+                for (Waiter **link = &stripe_.head; *link != nullptr; link = &(*link)->next) {
+                    if (*link == &waiter) {
+                        unlink(link);
+                        break;
+                    }
+                }
+                return true;
+            }
+
+            void notify(bool all) {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (stripe_.waiters.load(std::memory_order_relaxed) == 0) {
+                    return;
+                }
+                std::lock_guard<std::mutex> lock(stripe_.mutex);
+                Waiter **link = &stripe_.head;
+                while (*link != nullptr) {
+                    Waiter *waiter = *link;
+                    if (waiter->address != address_) {
+                        link = &waiter->next;
+                        continue;
+                    }
+                    unlink(link);
+                    waiter->woken.store(1, std::memory_order_release);
+                    futexWake(waiter->woken, false);
+                    if (!all) {
+                        return;
+                    }
+                }
+            }
+
+            void unlink(Waiter **link) {
+                Waiter *waiter = *link;
+                *link = waiter->next;
+                if (stripe_.tail == &waiter->next) {
+                    stripe_.tail = link;
+                }
+                stripe_.waiters.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+        private:
+            Stripe &stripe_;
+            const void *address_;
+        };
+
+    public:
+        static Parking of(const void *address) {
+            static std::array<Stripe, kStripes> stripes;
+            auto key = reinterpret_cast<uintptr_t>(address);
+            return Parking(stripes[(key >> 4 ^ key >> 12) % kStripes], address);
+        }
+    };
+}// namespace lu::detail
+
+#endif//ATOMIC_SHARED_POINTER_FUTEX_H
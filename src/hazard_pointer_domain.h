@@ -25,22 +25,23 @@ namespace lu::detail {
         public:
             HazardPtr() = default;
 
+            // reads of the protected object happen before a scan that sees the hazard cleared
             void clear() {
-                hazard_ptr_.store(nullptr);
+                hazard_ptr_.store(nullptr, std::memory_order_release);
             }
 
             template <class TValue>
-            void store(TValue *hazard_ptr) {
-                hazard_ptr_.store(reinterpret_cast<hazard_ptr_t>(hazard_ptr));
+            void store(TValue *hazard_ptr, std::memory_order order = std::memory_order_seq_cst) {
+                hazard_ptr_.store(reinterpret_cast<hazard_ptr_t>(hazard_ptr), order);
             }
 
-            hazard_ptr_t load() const {
-                return hazard_ptr_.load();
+            hazard_ptr_t load(std::memory_order order = std::memory_order_seq_cst) const {
+                return hazard_ptr_.load(order);
             }
 
             template <class TValue>
-            TValue *loadAs() const {
-                return reinterpret_cast<TValue *>(hazard_ptr_.load());
+            TValue *loadAs(std::memory_order order = std::memory_order_seq_cst) const {
+                return reinterpret_cast<TValue *>(hazard_ptr_.load(order));
             }
 
         private:
@@ -367,16 +368,43 @@ namespace lu::detail {
             }
         }
 
+        // the hazard is published with a relaxed store followed by a seq_cst fence that pairs with the fence in
+        // scan(), only the validating load takes the requested order
         template <class TValue>
-        GuardedPtr<TValue> protect(const std::atomic<TValue *> &ptr) {
+        GuardedPtr<TValue> protect(const std::atomic<TValue *> &ptr, std::memory_order order = std::memory_order_seq_cst) {
+            uintptr_t tag;
+            return protectTagged(ptr, 0, tag, order);
+        }
+
+        // protect() for a word that keeps tag bits under tag_mask next to the pointer: the hazard and the result
+        // hold the untagged pointer, the tag the validating load has seen is returned through tag
+        template <class TValue>
+        GuardedPtr<TValue> protectTagged(const std::atomic<TValue *> &ptr, uintptr_t tag_mask, uintptr_t &tag,
+                                         std::memory_order order = std::memory_order_seq_cst) {
+            ThreadData &thread_data = entries_.getValue();
+            HazardPtr *hazard_ptr = thread_data.acquireHP();
+            auto word = reinterpret_cast<uintptr_t>(ptr.load(std::memory_order_relaxed));
+            while (true) {
+                hazard_ptr->store(reinterpret_cast<TValue *>(word & ~tag_mask), std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                auto validated = reinterpret_cast<uintptr_t>(ptr.load(dereferenceOrder(order)));
+                if ((validated & ~tag_mask) == (word & ~tag_mask)) {
+                    word = validated;
+                    break;
+                }
+                word = validated;
+            }
+            tag = word & tag_mask;
+            return GuardedPtr<TValue>(reinterpret_cast<TValue *>(word & ~tag_mask), hazard_ptr);
+        }
+
+        // protects a pointer the caller still owns, e.g. right before retiring it
+        template <class TValue>
+        GuardedPtr<TValue> guard(TValue *ptr) {
             ThreadData &thread_data = entries_.getValue();
             HazardPtr *hazard_ptr = thread_data.acquireHP();
-            TValue *result;
-            do {
-                result = ptr.load();
-                hazard_ptr->store(result);
-            } while (result != ptr.load());
-            return GuardedPtr<TValue>(result, hazard_ptr);
+            hazard_ptr->store(ptr);
+            return GuardedPtr<TValue>(ptr, hazard_ptr);
         }
 
         template <class Disposer, class TValue>
@@ -420,13 +448,14 @@ namespace lu::detail {
             RetiredPtr *ret_beg = thread_data.retires.begin();
             RetiredPtr *ret_end = thread_data.retires.end();
             std::sort(ret_beg, ret_end);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
             for (auto thread_it = entries_.begin(); thread_it != entries_.end(); ++thread_it) {
                 if (!thread_it->isAcquired()) {
                     continue;
                 }
                 ThreadData &other_td = thread_it->value();
                 for (auto hp = other_td.hazards.begin(); hp != other_td.hazards.end(); ++hp) {
-                    auto ptr = hp->load();
+                    auto ptr = hp->load(std::memory_order_acquire);
                     if (ptr != nullptr) {
                         RetiredPtr dummy_retired(ptr, nullptr);
                         RetiredPtr *res = std::lower_bound(ret_beg, ret_end, dummy_retired);
@@ -0,0 +1,122 @@
+//
+// Created by ludaludaed on 18.10.2026.
+//
+
+#ifndef ATOMIC_SHARED_POINTER_MARKABLE_ATOMIC_SHARED_POINTER_H
+#define ATOMIC_SHARED_POINTER_MARKABLE_ATOMIC_SHARED_POINTER_H
+
+#include "atomic_shared_pointer.h"
+#include <atomic>
+#include <cstdint>
+
+namespace lu::detail {
+    template <class TValue>
+    struct MarkedSharedPtr {
+        SharedPtr<TValue> ptr;
+        bool mark{false};
+    };
+
+    // AtomicSharedPtr with a mark bit fused into the low bit of the control block pointer, as logical deletion in
+    // Harris style lists and trees needs: marking a node's successor link and changing the link are one CAS.
+    // The atomic holds a reference to the stored control block whatever the mark, hazard pointers and retired
+    // pointers always carry the untagged control block.
+    template <class TValue, class Reclaimer>
+    class MarkableAtomicSharedPtr {
+        using InternalReclaimer = ReclaimerTraits<Reclaimer>;
+
+        static constexpr uintptr_t kMark = 1;
+
+    public:
+        using Marked = MarkedSharedPtr<TValue>;
+
+        static constexpr bool is_always_lock_free = true;
+
+    public:
+        MarkableAtomicSharedPtr() : word_(nullptr) {}
+
+        MarkableAtomicSharedPtr(const MarkableAtomicSharedPtr &) = delete;
+
+        MarkableAtomicSharedPtr(MarkableAtomicSharedPtr &&) = delete;
+
+        ~MarkableAtomicSharedPtr() {
+            ControlBlockBase *ptr = pointer(word_.load());
+            if (ptr != nullptr) {
+                ptr->decrementRef();
+            }
+        }
+
+        MarkableAtomicSharedPtr &operator=(const MarkableAtomicSharedPtr &) = delete;
+
+        MarkableAtomicSharedPtr &operator=(MarkableAtomicSharedPtr &&) = delete;
+
+        [[nodiscard]] bool is_lock_free() const noexcept {
+            return true;
+        }
+
+        void store(SharedPtr<TValue> ptr, bool mark = false, std::memory_order order = std::memory_order_seq_cst) {
+            ptr.unalias();
+            ControlBlockBase *old_ptr = pointer(word_.exchange(tagged(ptr.release(), mark), order));
+            if (old_ptr != nullptr) {
+                InternalReclaimer::delayDecrementRef(old_ptr);
+            }
+        }
+
+        Marked load(std::memory_order order = std::memory_order_seq_cst) const {
+            uintptr_t tag;
+            auto guarded = InternalReclaimer::protectTagged(word_, kMark, tag, order);
+            if (guarded.get() == nullptr) {
+                return Marked{SharedPtr<TValue>{}, tag != 0};
+            }
+            guarded->incrementRef();
+            return Marked{SharedPtr<TValue>(guarded.get()), tag != 0};
+        }
+
+        bool isMarked(std::memory_order order = std::memory_order_seq_cst) const {
+            return reinterpret_cast<uintptr_t>(word_.load(order)) & kMark;
+        }
+
+        // replaces the pair only if the atomic stores the control block of expected.ptr with expected.mark,
+        // on failure expected is reloaded
+        bool compareExchange(Marked &expected, Marked desired, std::memory_order order = std::memory_order_seq_cst) {
+            desired.ptr.unalias();
+            ControlBlockBase *expected_word = tagged(expected.ptr.control_block_, expected.mark);
+            ControlBlockBase *desired_word = tagged(desired.ptr.control_block_, desired.mark);
+            if (word_.compare_exchange_strong(expected_word, desired_word, order, failureOrder(order))) {
+                ControlBlockBase *expected_ptr = pointer(expected_word);
+                if (expected_ptr != nullptr) {
+                    InternalReclaimer::delayDecrementRef(expected_ptr);
+                }
+                desired.ptr.release();
+                return true;
+            }
+            expected = load(failureOrder(order));
+            return false;
+        }
+
+        bool compareExchange(Marked &expected, SharedPtr<TValue> desired, bool desired_mark,
+                             std::memory_order order = std::memory_order_seq_cst) {
+            return compareExchange(expected, Marked{std::move(desired), desired_mark}, order);
+        }
+
+        // sets the mark if the atomic still stores expected unmarked, the stored reference is kept as it is
+        bool tryMark(const SharedPtr<TValue> &expected, std::memory_order order = std::memory_order_seq_cst) {
+            ControlBlockBase *expected_word = tagged(expected.control_block_, false);
+            return word_.compare_exchange_strong(expected_word, tagged(expected.control_block_, true), order,
+                                                 failureOrder(order));
+        }
+
+    private:
+        static ControlBlockBase *pointer(ControlBlockBase *word) {
+            return reinterpret_cast<ControlBlockBase *>(reinterpret_cast<uintptr_t>(word) & ~kMark);
+        }
+
+        static ControlBlockBase *tagged(ControlBlockBase *ptr, bool mark) {
+            return reinterpret_cast<ControlBlockBase *>(reinterpret_cast<uintptr_t>(ptr) | (mark ? kMark : 0));
+        }
+
+    private:
+        std::atomic<ControlBlockBase *> word_;
+    };
+}// namespace lu::detail
+
+#endif//ATOMIC_SHARED_POINTER_MARKABLE_ATOMIC_SHARED_POINTER_H
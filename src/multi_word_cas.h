@@ -0,0 +1,227 @@
+//
+// Created by ludaludaed on 18.10.2026.
+//
+
+#ifndef ATOMIC_SHARED_POINTER_MULTI_WORD_CAS_H
+#define ATOMIC_SHARED_POINTER_MULTI_WORD_CAS_H
+
+#include "utils.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+namespace lu::detail {
+    class ControlBlockBase;
+
+    using ControlBlockWord = std::atomic<ControlBlockBase *>;
+
+    // Descriptor of a k-word compare and swap over control block words. It is installed into the words in
+    // address order and the operation takes effect when its status is decided.
+    struct alignas(64) McasDescriptor {
+        enum Status : uint8_t {
+            kUndecided,
+            kSucceeded,
+            kFailed
+        };
+
+        struct Entry {
+            ControlBlockWord *word;
+            ControlBlockBase *expected;
+            ControlBlockBase *desired;
+        };
+
+        static constexpr size_t kMaxWords = 16;
+
+        std::atomic<Status> status{kUndecided};
+        size_t size{0};
+        Entry entries[kMaxWords];
+    };
+
+    // Lock-free k-word CAS in the style of Harris, Fraser and Pratt. A word holds either a control block, the
+    // descriptor of an operation tagged with kMcasTag, or an RDCSS marker for entry i of a descriptor. The marker
+    // installs the descriptor only while its status is undecided, so a helper that is late cannot install it
+    // into a word that went back to the expected value after the operation finished. Markers need no memory of
+    // their own, the entry index lives in the low bits of the 64 byte aligned descriptor address.
+    // Threads that find a tagged word help the operation to its end, nesting up to kMaxHelpDepth foreign
+    // operations since each one holds a hazard pointer. A deeper chain unwinds to the top, which helps the word
+    // that blocked it and then retries, so nobody waits for another thread. Descriptors are retired to the hazard
+    // pointer domain.
+    // Reference counts are not touched here, the initiator pays for them once the outcome is known. Atomics that
+    // never take part in a k-CAS pay only a test of the tag bits of a word they load anyway.
+    template <class Reclaimer>
+    class MultiWordCas {
+        using GuardedDescriptor = typename Reclaimer::template GuardedPtr<McasDescriptor>;
+
+        static constexpr uintptr_t kMcasTag = 1;
+        static constexpr uintptr_t kRdcssTag = 2;
+        static constexpr uintptr_t kTagMask = 3;
+        static constexpr uintptr_t kIndexShift = 2;
+        static constexpr uintptr_t kDescriptorMask = alignof(McasDescriptor) - 1;
+        static constexpr size_t kMaxHelpDepth = 2;
+
+        static_assert(McasDescriptor::kMaxWords << kIndexShift <= alignof(McasDescriptor));
+
+    public:
+        static constexpr uintptr_t kMask = kTagMask;
+
+        static bool isDescriptor(ControlBlockBase *word) {
+            return reinterpret_cast<uintptr_t>(word) & kTagMask;
+        }
+
+        // runs the operation of a descriptor the caller owns, returns true if all words were swapped
+        static bool run(McasDescriptor *descriptor) {
+            std::sort(descriptor->entries, descriptor->entries + descriptor->size,
+                      [](const McasDescriptor::Entry &lhs, const McasDescriptor::Entry &rhs) {
+                          return lhs.word < rhs.word;
+                      });
+            for (size_t i = 1; i < descriptor->size; ++i) {
+                assert(descriptor->entries[i - 1].word != descriptor->entries[i].word && "Duplicate word");
+            }
+            while (true) {
+                ControlBlockWord *blocked = nullptr;
+                bool succeeded = help(descriptor, 0, blocked);
+                if (blocked == nullptr) {
+                    return succeeded;
+                }
+                helpChain(*blocked);
+            }
+        }
+
+        static void retire(McasDescriptor *descriptor) {
+            Reclaimer::instance().template retire<DefaultDeleter>(descriptor);
+        }
+
+        // completes whatever operation is installed in word, if any
+        static void helpWord(ControlBlockWord &word) {
+            helpChain(word);
+        }
+
+    private:
+        static ControlBlockBase *mcasWord(McasDescriptor *descriptor) {
+            return reinterpret_cast<ControlBlockBase *>(reinterpret_cast<uintptr_t>(descriptor) | kMcasTag);
+        }
+
+        static ControlBlockBase *rdcssWord(McasDescriptor *descriptor, size_t index) {
+            return reinterpret_cast<ControlBlockBase *>(reinterpret_cast<uintptr_t>(descriptor) |
+                                                        index << kIndexShift | kRdcssTag);
+        }
+
+        static McasDescriptor *descriptorOf(ControlBlockBase *word) {
+            return reinterpret_cast<McasDescriptor *>(reinterpret_cast<uintptr_t>(word) & ~kDescriptorMask);
+        }
+
+        static size_t indexOf(ControlBlockBase *word) {
+            return (reinterpret_cast<uintptr_t>(word) & kDescriptorMask) >> kIndexShift;
+        }
+
+        // the descriptor of a tagged word stays alive while the guard is held, the guard is empty if the word
+        // changed in the meantime
+        static GuardedDescriptor protectDescriptor(ControlBlockWord &word, ControlBlockBase *observed) {
+            GuardedDescriptor guarded = Reclaimer::instance().guard(descriptorOf(observed));
+            if (word.load() != observed) {
+                return GuardedDescriptor{};
+            }
+            return guarded;
+        }
+
+        // helps the operation in word and, whenever the chain behind it is too deep, the one that blocked it
+        static void helpChain(ControlBlockWord &word) {
+            ControlBlockWord *next = &word;
+            while (next != nullptr) {
+                ControlBlockWord *current = next;
+                next = nullptr;
+                helpWord(*current, 1, next);
+            }
+        }
+
+        // sets blocked and returns without helping if the hazard pointers of the chain are used up
+        static void helpWord(ControlBlockWord &word, size_t depth, ControlBlockWord *&blocked) {
+            ControlBlockBase *observed = word.load();
+            if (!isDescriptor(observed)) {
+                return;
+            }
+            if (depth > kMaxHelpDepth) {
+                blocked = &word;
+                return;
+            }
+            GuardedDescriptor guarded = protectDescriptor(word, observed);
+            if (!guarded) {
+                return;
+            }
+            if (reinterpret_cast<uintptr_t>(observed) & kRdcssTag) {
+                completeRdcss(guarded.get(), indexOf(observed), observed);
+            } else {
+                help(guarded.get(), depth, blocked);
+            }
+        }
+
+        static void completeRdcss(McasDescriptor *descriptor, size_t index, ControlBlockBase *marker) {
+            McasDescriptor::Entry &entry = descriptor->entries[index];
+            ControlBlockBase *value = descriptor->status.load() == McasDescriptor::kUndecided
+                                              ? mcasWord(descriptor)
+                                              : entry.expected;
+            entry.word->compare_exchange_strong(marker, value);
+        }
+
+        // returns false if the word does not hold the expected value or the chain below was too deep to help
+        static bool install(McasDescriptor *descriptor, size_t index, size_t depth, ControlBlockWord *&blocked) {
+            McasDescriptor::Entry &entry = descriptor->entries[index];
+            ControlBlockBase *installed = mcasWord(descriptor);
+            ControlBlockBase *marker = rdcssWord(descriptor, index);
+            while (descriptor->status.load() == McasDescriptor::kUndecided) {
+                ControlBlockBase *current = entry.word->load();
+                if (current == installed) {
+                    return true;
+                }
+                if (isDescriptor(current) && descriptorOf(current) == descriptor) {
+                    // another helper's marker for this entry
+                    completeRdcss(descriptor, index, current);
+                    continue;
+                }
+                if (isDescriptor(current)) {
+                    helpWord(*entry.word, depth + 1, blocked);
+                    if (blocked != nullptr) {
+                        return false;
+                    }
+                    continue;
+                }
+                if (current != entry.expected) {
+                    return false;
+                }
+                if (entry.word->compare_exchange_strong(current, marker)) {
+                    completeRdcss(descriptor, index, marker);
+                }
+            }
+            return true;
+        }
+
+        // leaves the operation undecided if blocked is set
+        static bool help(McasDescriptor *descriptor, size_t depth, ControlBlockWord *&blocked) {
+            if (descriptor->status.load() == McasDescriptor::kUndecided) {
+                auto outcome = McasDescriptor::kSucceeded;
+                for (size_t i = 0; i < descriptor->size; ++i) {
+                    if (!install(descriptor, i, depth, blocked)) {
+                        if (blocked != nullptr) {
+                            return false;
+                        }
+                        outcome = McasDescriptor::kFailed;
+                        break;
+                    }
+                }
+                auto expected = McasDescriptor::kUndecided;
+                descriptor->status.compare_exchange_strong(expected, outcome);
+            }
+            bool succeeded = descriptor->status.load() == McasDescriptor::kSucceeded;
+            ControlBlockBase *installed = mcasWord(descriptor);
+            for (size_t i = 0; i < descriptor->size; ++i) {
+                McasDescriptor::Entry &entry = descriptor->entries[i];
+                ControlBlockBase *current = installed;
+                entry.word->compare_exchange_strong(current, succeeded ? entry.desired : entry.expected);
+            }
+            return succeeded;
+        }
+    };
+}// namespace lu::detail
+
+#endif//ATOMIC_SHARED_POINTER_MULTI_WORD_CAS_H
@@ -0,0 +1,330 @@
+//
+// Created by ludaludaed on 18.10.2026.
+//
+
+#ifndef ATOMIC_SHARED_POINTER_SLAB_ALLOCATOR_H
+#define ATOMIC_SHARED_POINTER_SLAB_ALLOCATOR_H
+
+#include "thread_entry_list.h"
+#include "utils.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+
+namespace lu::detail {
+    // Size class slab allocator for small blocks. Every thread allocates from pages of its own heap without any
+    // synchronization. A block freed by another thread is pushed to the remote free list of its page, the owner
+    // takes the whole list at once when the page runs out of local blocks. Pages that become empty go back to a
+    // shared pool and are reused for any size class. Heaps are thread entries, the heap of an exited thread is
+    // adopted together with its pages by the next thread that acquires the entry.
+    class SlabHeap {
+        static constexpr size_t kPageSize = size_t(64) * 1024;
+        static constexpr size_t kGranule = 16;
+        static constexpr size_t kMaxBlockSize = 2048;
+        static constexpr size_t kMaxPooledPages = 64;
+
+        static constexpr std::array<size_t, 24> kSizeClasses = {16, 32, 48, 64, 80, 96, 112, 128,
+                                                                 160, 192, 224, 256, 320, 384, 448, 512,
+                                                                 640, 768, 896, 1024, 1280, 1536, 1792, 2048};
+
+        struct FreeBlock {
+            FreeBlock *next;
+        };
+
+        struct ThreadHeap;
+
+        using HeapList = ThreadEntryList<ThreadHeap>;
+        using Heap = typename HeapList::Entry;
+
+        struct Page {
+            // only the owner touches the fields up to remote_free
+            Heap *owner;
+            Page *prev;
+            Page *next;
+            FreeBlock *local_free;
+            std::byte *bump;
+            size_t block_size;
+            size_t used;
+            alignas(kCacheLineSize) std::atomic<FreeBlock *> remote_free;
+
+            std::byte *end() {
+                return reinterpret_cast<std::byte *>(this) + kPageSize;
+            }
+
+            // returns true if the page has no blocks in use afterwards
+            bool collectRemote() {
+                if (remote_free.load(std::memory_order_relaxed) == nullptr) {
+                    return used == 0;
+                }
+                FreeBlock *block = remote_free.exchange(nullptr, std::memory_order_acquire);
+                while (block != nullptr) {
+                    FreeBlock *next = block->next;
+                    block->next = local_free;
+                    local_free = block;
+                    --used;
+                    block = next;
+                }
+                return used == 0;
+            }
+
+            void *take() {
+                if (local_free == nullptr) {
+                    collectRemote();
+                }
+                if (local_free != nullptr) {
+                    FreeBlock *block = local_free;
+                    local_free = block->next;
+                    ++used;
+                    return block;
+                }
+                if (bump + block_size <= end()) {
+                    std::byte *block = bump;
+                    bump += block_size;
+                    ++used;
+                    return block;
+                }
+                return nullptr;
+            }
+        };
+
+        static constexpr size_t kPageHeader = (sizeof(Page) + kCacheLineSize - 1) / kCacheLineSize * kCacheLineSize;
+
+        struct ThreadHeap {
+            std::array<Page *, kSizeClasses.size()> pages{};
+        };
+
+        struct HeapGuard {
+            ~HeapGuard() {
+                Heap *heap = current_heap_;
+                current_heap_ = nullptr;
+                heap_released_ = true;
+                if (heap != nullptr) {
+                    heap->release();
+                }
+            }
+        };
+
+        struct PagePool {
+            std::mutex mutex;
+            Page *head{nullptr};
+            size_t size{0};
+        };
+
+        static constexpr std::array<uint8_t, kMaxBlockSize / kGranule + 1> kClassOf = [] {
+            std::array<uint8_t, kMaxBlockSize / kGranule + 1> result{};
+            size_t size_class = 0;
+            for (size_t granules = 0; granules < result.size(); ++granules) {
+                while (kSizeClasses[size_class] < granules * kGranule) {
+                    ++size_class;
+                }
+                result[granules] = static_cast<uint8_t>(size_class);
+            }
+            return result;
+        }();
+
+    public:
+        static bool fits(size_t size, size_t alignment) {
+            return size <= kMaxBlockSize && alignment <= kGranule;
+        }
+
+        static void *allocate(size_t size) {
+            size_t size_class = kClassOf[(size + kGranule - 1) / kGranule];
+            Heap *heap = current_heap_;
+            if (heap == nullptr) {
+                if (heap_released_) {
+                    // the thread is exiting, a heap is borrowed for this allocation only
+                    Heap *borrowed = heaps().acquireEntry();
+                    void *result = allocateFrom(borrowed, size_class);
+                    borrowed->release();
+                    return result;
+                }
+                heap = acquireHeap();
+            }
+            return allocateFrom(heap, size_class);
+        }
+
+        static void deallocate(void *ptr) {
+            Page *page = pageOf(ptr);
+            auto *block = static_cast<FreeBlock *>(ptr);
+            Heap *heap = current_heap_;
+            if (heap != nullptr && page->owner == heap) {
+                block->next = page->local_free;
+                page->local_free = block;
+                --page->used;
+                // the rest of the page may have been freed by other threads
+                if (page->collectRemote()) {
+                    releaseIfIdle(heap, page);
+                }
+                return;
+            }
+            FreeBlock *head = page->remote_free.load(std::memory_order_relaxed);
+            do {
+                block->next = head;
+            } while (!page->remote_free.compare_exchange_weak(head, block, std::memory_order_release,
+                                                              std::memory_order_relaxed));
+        }
+
+    private:
+        static Page *pageOf(void *ptr) {
+            return reinterpret_cast<Page *>(reinterpret_cast<uintptr_t>(ptr) & ~(kPageSize - 1));
+        }
+
+        static void *allocateFrom(Heap *heap, size_t size_class) {
+            Page *&head = heap->value().pages[size_class];
+            for (Page *page = head, *next; page != nullptr; page = next) {
+                next = page->next;
+                // a page behind the head whose blocks all came back from other threads goes to the pool
+                if (page != head && page->local_free == nullptr && page->collectRemote()) {
+                    releaseIfIdle(heap, page);
+                    continue;
+                }
+                void *block = page->take();
+                if (block != nullptr) {
+                    if (page != head) {
+                        unlink(head, page);
+                        pushFront(head, page);
+                    }
+                    return block;
+                }
+            }
+            Page *page = newPage(heap, kSizeClasses[size_class]);
+            pushFront(head, page);
+            return page->take();
+        }
+
+        // the first page of a class is kept even when empty, so a single block freed and allocated in a loop
+        // does not move pages through the pool
+        static void releaseIfIdle(Heap *heap, Page *page) {
+            size_t size_class = kClassOf[page->block_size / kGranule];
+            Page *&head = heap->value().pages[size_class];
+            if (page == head) {
+                return;
+            }
+            unlink(head, page);
+            PagePool &pool = pagePool();
+            std::unique_lock lock(pool.mutex);
+            if (pool.size == kMaxPooledPages) {
+                lock.unlock();
+                std::free(page);
+                return;
+            }
+            page->next = pool.head;
+            pool.head = page;
+            ++pool.size;
+        }
+
+        static Page *newPage(Heap *heap, size_t block_size) {
+            Page *page = nullptr;
+            {
+                PagePool &pool = pagePool();
+                std::lock_guard lock(pool.mutex);
+                if (pool.head != nullptr) {
+                    page = pool.head;
+                    pool.head = page->next;
+                    --pool.size;
+                }
+            }
+            if (page == nullptr) {
+                void *memory = std::aligned_alloc(kPageSize, kPageSize);
+                if (memory == nullptr) {
+                    throw std::bad_alloc();
+                }
+                page = ::new(memory) Page();
+            }
+            page->owner = heap;
+            page->prev = nullptr;
+            page->next = nullptr;
+            page->local_free = nullptr;
+            page->bump = reinterpret_cast<std::byte *>(page) + kPageHeader;
+            page->block_size = block_size;
+            page->used = 0;
+            page->remote_free.store(nullptr, std::memory_order_relaxed);
+            return page;
+        }
+
+        static void pushFront(Page *&head, Page *page) {
+            page->prev = nullptr;
+            page->next = head;
+            if (head != nullptr) {
+                head->prev = page;
+            }
+            head = page;
+        }
+
+        static void unlink(Page *&head, Page *page) {
+            if (page->prev != nullptr) {
+                page->prev->next = page->next;
+            } else {
+                head = page->next;
+            }
+            if (page->next != nullptr) {
+                page->next->prev = page->prev;
+            }
+        }
+
+        static HeapList &heaps() {
+            // never destroyed: blocks may be freed during static destruction
+            static HeapList *list = new HeapList();
+            return *list;
+        }
+
+        static PagePool &pagePool() {
+            static PagePool *pool = new PagePool();
+            return *pool;
+        }
+
+        static Heap *acquireHeap() {
+            thread_local HeapGuard guard;
+            current_heap_ = heaps().acquireEntry();
+            return current_heap_;
+        }
+
+    private:
+        static inline thread_local Heap *current_heap_{nullptr};
+        static inline thread_local bool heap_released_{false};
+    };
+
+    // Standard allocator on top of SlabHeap, requests that do not fit a size class go to std::allocator.
+    template <class TValue>
+    class SlabAllocator {
+    public:
+        using value_type = TValue;
+
+        SlabAllocator() = default;
+
+        template <class TTValue>
+        SlabAllocator(const SlabAllocator<TTValue> &) {}
+
+        TValue *allocate(size_t n) {
+            if (SlabHeap::fits(n * sizeof(TValue), alignof(TValue))) {
+                return static_cast<TValue *>(SlabHeap::allocate(n * sizeof(TValue)));
+            }
+            return std::allocator<TValue>().allocate(n);
+        }
+
+        void deallocate(TValue *ptr, size_t n) {
+            if (SlabHeap::fits(n * sizeof(TValue), alignof(TValue))) {
+                SlabHeap::deallocate(ptr);
+            } else {
+                std::allocator<TValue>().deallocate(ptr, n);
+            }
+        }
+
+        template <class TTValue>
+        bool operator==(const SlabAllocator<TTValue> &) const {
+            return true;
+        }
+
+        template <class TTValue>
+        bool operator!=(const SlabAllocator<TTValue> &) const {
+            return false;
+        }
+    };
+}// namespace lu::detail
+
+#endif//ATOMIC_SHARED_POINTER_SLAB_ALLOCATOR_H
@@ -0,0 +1,354 @@
+//
+// Created by ludaludaed on 18.10.2026.
+//
+
+#ifndef ATOMIC_SHARED_POINTER_SPLIT_REF_COUNT_H
+#define ATOMIC_SHARED_POINTER_SPLIT_REF_COUNT_H
+
+#include "atomic_shared_pointer.h"
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+namespace lu::detail {
+    // Reclaimer tag selecting the split reference count AtomicSharedPtr.
+    struct SplitRefCount {};
+
+    // Loads of the split count atomic never touch the control block, so a snapshot simply holds a loaded reference.
+    template <class TValue>
+    class SnapshotPtr<TValue, SplitRefCount> {
+        template <class TTValue, class TReclaimer>
+        friend class AtomicSharedPtr;
+
+    public:
+        using element_type = std::remove_extent_t<TValue>;
+
+        SnapshotPtr() = default;
+
+        SnapshotPtr(const SnapshotPtr &) = delete;
+
+        SnapshotPtr(SnapshotPtr &&) noexcept = default;
+
+        SnapshotPtr &operator=(const SnapshotPtr &) = delete;
+
+        SnapshotPtr &operator=(SnapshotPtr &&) noexcept = default;
+
+        element_type *get() const {
+            return ptr_.get();
+        }
+
+        element_type &operator*() const {
+            return *ptr_;
+        }
+
+        element_type *operator->() const {
+            return ptr_.get();
+        }
+
+        explicit operator bool() const {
+            return static_cast<bool>(ptr_);
+        }
+
+        SharedPtr<TValue> promote() {
+            return ptr_;
+        }
+
+    private:
+        explicit SnapshotPtr(SharedPtr<TValue> ptr) : ptr_(std::move(ptr)) {}
+
+    private:
+        SharedPtr<TValue> ptr_;
+    };
+
+    // The atomic word holds the control block pointer in the low 48 bits and the number of references handed out
+    // by load() in the high 16 bits. The atomic owns a batch of kBatch references to the stored control block,
+    // load() takes one of them with a single fetch_add, and whoever replaces the pointer gives back the rest.
+    // Loaders that see a quarter of the batch spent refill it. Beyond that point loads take their reference with a
+    // CAS that leaves the count below half the batch and back off at the limit until a refill lands, so the count
+    // never reaches the batch; fetch_adds could only overrun it with three quarters of a batch of loads in flight.
+    template <class TValue>
+    class AtomicSharedPtr<TValue, SplitRefCount> {
+        template <class TTValue, class TReclaimer>
+        friend class CachedReader;
+
+        static constexpr int kCountShift = 48;
+        static constexpr uintptr_t kCountOne = uintptr_t(1) << kCountShift;
+        static constexpr uintptr_t kPointerMask = kCountOne - 1;
+        static constexpr size_t kBatch = size_t(1) << 15;
+        static constexpr size_t kRefillThreshold = kBatch / 4;
+        static constexpr size_t kLoadLimit = kBatch / 2;
+
+    public:
+        using Snapshot = SnapshotPtr<TValue, SplitRefCount>;
+
+        static constexpr bool is_always_lock_free = true;
+
+    public:
+        AtomicSharedPtr() : word_(0) {}
+
+        AtomicSharedPtr(const AtomicSharedPtr &) = delete;
+
+        AtomicSharedPtr(AtomicSharedPtr &&) = delete;
+
+        ~AtomicSharedPtr() {
+            releaseWord(word_.load());
+        }
+
+        AtomicSharedPtr &operator=(const AtomicSharedPtr &) = delete;
+
+        AtomicSharedPtr &operator=(AtomicSharedPtr &&) = delete;
+
+        AtomicSharedPtr &operator=(SharedPtr<TValue> other) {
+            store(std::move(other));
+            return *this;
+        }
+
+        [[nodiscard]] bool is_lock_free() const noexcept {
+            return true;
+        }
+
+        void store(SharedPtr<TValue> ptr, std::memory_order order = std::memory_order_seq_cst) {
+            ptr.unalias();
+            uintptr_t new_word = acquireBatch(ptr.control_block_);
+            ptr.release();
+            uintptr_t old_word = word_.exchange(new_word, replaceOrder(order));
+            releaseWord(old_word);
+        }
+
+        SharedPtr<TValue> load(std::memory_order order = std::memory_order_seq_cst) const {
+            uintptr_t word = word_.load(std::memory_order_relaxed);
+            if (pointer(word) == nullptr || countOf(word) < kRefillThreshold) {
+                word = word_.fetch_add(kCountOne, dereferenceOrder(order));
+            } else {
+                word = takeBounded(word, order);
+            }
+            ControlBlockBase *control_block = pointer(word);
+            if (control_block == nullptr) {
+                // the count of an empty word is never read, letting it wrap around is harmless
+                return SharedPtr<TValue>{};
+            }
+            size_t count = countOf(word) + 1;
+            if (count >= kRefillThreshold) {
+                refill(word + kCountOne, count);
+            }
+            return SharedPtr<TValue>(control_block);
+        }
+
+        Snapshot snapshot(std::memory_order order = std::memory_order_seq_cst) const {
+            return Snapshot(load(order));
+        }
+
+        template <class Fn>
+        decltype(auto) read(Fn &&fn, std::memory_order order = std::memory_order_seq_cst) const {
+            Snapshot current = snapshot(order);
+            return std::forward<Fn>(fn)(static_cast<const typename Snapshot::element_type *>(current.get()));
+        }
+
+        // RCU style update: fn gets the current value (or nullptr) and returns its replacement, which is published
+        // only if the atomic still stores the value fn has seen, otherwise fn runs again on the newer value
+        template <class Fn>
+        SharedPtr<TValue> update(Fn &&fn, std::memory_order order = std::memory_order_seq_cst) {
+            Backoff backoff;
+            Snapshot current = snapshot(failureOrder(order));
+            while (true) {
+                SharedPtr<TValue> desired = fn(static_cast<const typename Snapshot::element_type *>(current.get()));
+                if (compareExchange(current, desired, order)) {
+                    return desired;
+                }
+                backoff.pause();
+            }
+        }
+
+        // a single attempt of update(), returns false if the atomic was changed concurrently
+        template <class Fn>
+        bool tryUpdate(Fn &&fn, std::memory_order order = std::memory_order_seq_cst) {
+            Snapshot current = snapshot(failureOrder(order));
+            SharedPtr<TValue> desired = fn(static_cast<const typename Snapshot::element_type *>(current.get()));
+            return compareExchange(current, std::move(desired), order);
+        }
+
+        // blocks until the atomic no longer stores old, stores do not notify by themselves
+        void wait(const SharedPtr<TValue> &old, std::memory_order order = std::memory_order_seq_cst) const {
+            if (!old.isAliased()) {
+                ControlBlockBase *old_ptr = old.control_block_;
+                ParkingLot::of(&word_).waitUntil([&] { return pointer(word_.load(order)) != old_ptr; });
+                return;
+            }
+            ParkingLot::of(&word_).waitUntil([&] { return !stands(load(order).control_block_, old); });
+        }
+
+        void notifyOne() const {
+            ParkingLot::of(&word_).notifyOne();
+        }
+
+        void notifyAll() const {
+            ParkingLot::of(&word_).notifyAll();
+        }
+
+        SharedPtr<TValue> exchange(SharedPtr<TValue> ptr, std::memory_order order = std::memory_order_seq_cst) {
+            ptr.unalias();
+            uintptr_t new_word = acquireBatch(ptr.control_block_);
+            ptr.release();
+            uintptr_t old_word = word_.exchange(new_word, replaceOrder(order));
+            ControlBlockBase *old_ptr = pointer(old_word);
+            if (old_ptr != nullptr) {
+                size_t unused = kBatch - countOf(old_word) - 1;
+                if (unused != 0) {
+                    old_ptr->decrementRef(unused);
+                }
+            }
+            return SharedPtr<TValue>(old_ptr);
+        }
+
+        bool compareExchange(SharedPtr<TValue> &expected, SharedPtr<TValue> desired) {
+            return compareExchangeStrong(expected, std::move(desired));
+        }
+
+        bool compareExchange(Snapshot &expected, SharedPtr<TValue> desired,
+                             std::memory_order order = std::memory_order_seq_cst) {
+            return compareExchangeImpl<false>(expected.ptr_, std::move(desired), order, failureOrder(order));
+        }
+
+        bool compareExchangeWeak(SharedPtr<TValue> &expected, SharedPtr<TValue> desired, std::memory_order success,
+                                 std::memory_order failure) {
+            return compareExchangeImpl<true>(expected, std::move(desired), success, failure);
+        }
+
+        bool compareExchangeWeak(SharedPtr<TValue> &expected, SharedPtr<TValue> desired,
+                                 std::memory_order order = std::memory_order_seq_cst) {
+            return compareExchangeImpl<true>(expected, std::move(desired), order, failureOrder(order));
+        }
+
+        bool compareExchangeStrong(SharedPtr<TValue> &expected, SharedPtr<TValue> desired, std::memory_order success,
+                                   std::memory_order failure) {
+            return compareExchangeImpl<false>(expected, std::move(desired), success, failure);
+        }
+
+        bool compareExchangeStrong(SharedPtr<TValue> &expected, SharedPtr<TValue> desired,
+                                   std::memory_order order = std::memory_order_seq_cst) {
+            return compareExchangeImpl<false>(expected, std::move(desired), order, failureOrder(order));
+        }
+
+    private:
+        // the local count changes under concurrent loads, the strong form retries while the pointer still matches
+        template <bool Weak>
+        bool compareExchangeImpl(SharedPtr<TValue> &expected, SharedPtr<TValue> desired, std::memory_order success,
+                                 std::memory_order failure) {
+            desired.unalias();
+            ControlBlockBase *expected_ptr = expected.control_block_;
+            ControlBlockBase *desired_ptr = desired.control_block_;
+            bool prepared = false;
+            SharedPtr<TValue> current;
+            while (true) {
+                if (expected.isAliased()) {
+                    // the atomic stores an alias block of its own, the loaded reference keeps it alive meanwhile
+                    current = load(failure);
+                    if (!stands(current.control_block_, expected)) {
+                        break;
+                    }
+                    expected_ptr = current.control_block_;
+                }
+                uintptr_t word = word_.load(std::memory_order_relaxed);
+                while (pointer(word) == expected_ptr) {
+                    if (!prepared && desired_ptr != nullptr) {
+                        checkFits(desired_ptr);
+                        desired_ptr->incrementRef(kBatch - 1);
+                        prepared = true;
+                    }
+                    if (word_.compare_exchange_weak(word, reinterpret_cast<uintptr_t>(desired_ptr),
+                                                    replaceOrder(success), std::memory_order_relaxed)) {
+                        desired.release();
+                        releaseWord(word);
+                        return true;
+                    }
+                    if (Weak) {
+                        break;
+                    }
+                }
+                if (Weak || !expected.isAliased()) {
+                    break;
+                }
+            }
+            if (prepared) {
+                desired_ptr->decrementRef(kBatch - 1);
+            }
+            expected = std::move(load(failure));
+            return false;
+        }
+
+        static ControlBlockBase *pointer(uintptr_t word) {
+            return reinterpret_cast<ControlBlockBase *>(word & kPointerMask);
+        }
+
+        static size_t countOf(uintptr_t word) {
+            return static_cast<size_t>(word >> kCountShift);
+        }
+
+        // the count takes the bits above 48, which user space addresses leave free unless five level paging is on
+        static void checkFits(ControlBlockBase *control_block) {
+            if (reinterpret_cast<uintptr_t>(control_block) & ~kPointerMask) {
+                throw std::runtime_error("control block address does not fit 48 bits");
+            }
+        }
+
+        // the caller's own reference becomes part of the batch
+        static uintptr_t acquireBatch(ControlBlockBase *control_block) {
+            if (control_block != nullptr) {
+                checkFits(control_block);
+                control_block->incrementRef(kBatch - 1);
+            }
+            return reinterpret_cast<uintptr_t>(control_block);
+        }
+
+        static void releaseWord(uintptr_t word) {
+            ControlBlockBase *control_block = pointer(word);
+            if (control_block != nullptr && countOf(word) != kBatch) {
+                control_block->decrementRef(kBatch - countOf(word));
+            }
+        }
+
+        bool holds(const SharedPtr<TValue> &ptr) const {
+            return pointer(word_.load(std::memory_order_acquire)) == ptr.control_block_;
+        }
+
+        // whether an alias block the caller holds a reference to stands for the aliased pointer
+        static bool stands(ControlBlockBase *ptr, const SharedPtr<TValue> &aliased) {
+            return ptr != nullptr && ptr->owner() == aliased.control_block_ &&
+                   ptr->get() == const_cast<void *>(static_cast<const volatile void *>(aliased.value_));
+        }
+
+        // the slow path of load() once a quarter of the batch is spent, word is the last value read
+        uintptr_t takeBounded(uintptr_t word, std::memory_order order) const {
+            Backoff backoff;
+            while (true) {
+                if (pointer(word) != nullptr && countOf(word) >= kLoadLimit) {
+                    // the loaders that took the spent references are refilling, a CAS of ours would only delay them
+                    backoff.pause();
+                    word = word_.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (word_.compare_exchange_weak(word, word + kCountOne, dereferenceOrder(order),
+                                                std::memory_order_relaxed)) {
+                    return word;
+                }
+            }
+        }
+
+        // the caller holds one of the handed out references, so the control block stays alive. The release CAS
+        // pairs with the acquiring exchange or CAS of the replacer: a replacer that reads the refilled word gives
+        // back references the increment added, which has to precede its decrement in the counter's order.
+        void refill(uintptr_t word, size_t count) const {
+            ControlBlockBase *control_block = pointer(word);
+            control_block->incrementRef(count);
+            if (!word_.compare_exchange_strong(word, word & kPointerMask, std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+                control_block->decrementRef(count);
+            }
+        }
+
+    private:
+        mutable std::atomic<uintptr_t> word_;
+    };
+}// namespace lu::detail
+
+#endif//ATOMIC_SHARED_POINTER_SPLIT_REF_COUNT_H
@@ -0,0 +1,81 @@
+//
+// Created by ludaludaed on 18.10.2026.
+//
+
+#ifndef ATOMIC_SHARED_POINTER_STICKY_COUNTER_H
+#define ATOMIC_SHARED_POINTER_STICKY_COUNTER_H
+
+#include "utils.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace lu::detail {
+    // Counter that sticks at zero: once it has dropped to zero, no increment can revive it.
+    // The zero state is encoded as a flag bit, so increment-if-not-zero is a single wait-free fetch_add. The last
+    // decrement sets the flag in the same CAS that takes the count to zero: a zero count without the flag would let
+    // an upgrade revive the object and release it again while the decrementer still touches the word.
+    // The count lives above kCountShift; the bits between the flag and the count are state of the owning class,
+    // which may run the word by its own rules and switch to the sticky ones by setting them.
+    class StickyCounter {
+    public:
+        static constexpr uintptr_t kZeroFlag = 1;
+        static constexpr int kCountShift = 4;
+        static constexpr uintptr_t kOne = uintptr_t(1) << kCountShift;
+
+    public:
+        explicit StickyCounter(uintptr_t word) : word_(word) {}
+
+        StickyCounter(const StickyCounter &) = delete;
+
+        StickyCounter &operator=(const StickyCounter &) = delete;
+
+        static intptr_t count(uintptr_t word) {
+            return static_cast<intptr_t>(word) >> kCountShift;
+        }
+
+        static uintptr_t withCount(uintptr_t word, intptr_t count) {
+            return (static_cast<uintptr_t>(count) << kCountShift) | (word & (kOne - 1));
+        }
+
+        // only if the counter is known to be not zero
+        void increment(size_t num, std::memory_order order = std::memory_order_relaxed) {
+            fetchAdd(word_, num * kOne, order);
+        }
+
+        bool incrementNotZero(size_t num, std::memory_order order = std::memory_order_relaxed) {
+            return (fetchAdd(word_, num * kOne, order) & kZeroFlag) == 0;
+        }
+
+        // returns true if the counter dropped to zero, state is what the owner bits hold in the sticky mode;
+        // with other owner bits set the count may reach zero without the flag, the owning class handles it then
+        bool decrement(size_t num, uintptr_t state = 0) {
+            uintptr_t value = word_.load(std::memory_order_relaxed);
+            while (true) {
+                bool last = value == withCount(state, static_cast<intptr_t>(num));
+                uintptr_t new_value = last ? state | kZeroFlag : value - num * kOne;
+                // the acquire of the last decrement reads from the release sequence of every earlier one
+                if (word_.compare_exchange_weak(value, new_value,
+                                                last ? std::memory_order_acq_rel : std::memory_order_release,
+                                                std::memory_order_relaxed)) {
+                    return last;
+                }
+            }
+        }
+
+        size_t load() const {
+            uintptr_t value = word_.load(std::memory_order_relaxed);
+            return (value & kZeroFlag) ? 0 : static_cast<size_t>(count(value));
+        }
+
+        // the raw word for the owner's own protocol
+        std::atomic<uintptr_t> &word() const {
+            return word_;
+        }
+
+    private:
+        mutable std::atomic<uintptr_t> word_;
+    };
+}// namespace lu::detail
+
+#endif//ATOMIC_SHARED_POINTER_STICKY_COUNTER_H
@@ -5,6 +5,7 @@
 #ifndef ATOMIC_SHARED_POINTER_THREAD_ENTRY_LIST_H
 #define ATOMIC_SHARED_POINTER_THREAD_ENTRY_LIST_H
 
+#include <atomic>
 #include <memory>
 #include "utils.h"
 
@@ -158,7 +159,7 @@ namespace lu {
             Entry *head = head_.load();
             do {
                 node->next_ = head;
-            } while (head_.compare_exchange_strong(head, node));
+            } while (!head_.compare_exchange_strong(head, node));
         }
 
         Entry *findFree() const {
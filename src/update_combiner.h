@@ -0,0 +1,141 @@
+//
+// Created by ludaludaed on 18.10.2026.
+//
+
+#ifndef ATOMIC_SHARED_POINTER_UPDATE_COMBINER_H
+#define ATOMIC_SHARED_POINTER_UPDATE_COMBINER_H
+
+#include "atomic_shared_pointer.h"
+#include "split_ref_count.h"
+#include "utils.h"
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+
+namespace lu::detail {
+    // Combines concurrent updates of one AtomicSharedPtr. Every updater publishes its mutator and one of them takes
+    // the combiner role: it copies the current value once, applies all pending mutators to the copy in arrival
+    // order and publishes the copy with a single compare exchange. N contending updaters then cost one copy and
+    // one successful CAS per batch instead of up to N of each per commit. Mutators run on the combiner thread,
+    // an exception thrown by a mutator is rethrown to its updater and the batch is redone without it.
+    template <class TValue, class Reclaimer>
+    class UpdateCombiner {
+        using Target = AtomicSharedPtr<TValue, Reclaimer>;
+
+        struct Request {
+            void (*apply)(void *, TValue &);
+            void *fn;
+            Request *next{nullptr};
+            std::exception_ptr error;
+            std::atomic<bool> done{false};
+        };
+
+    public:
+        explicit UpdateCombiner(Target &target) : target_(target) {}
+
+        UpdateCombiner(const UpdateCombiner &) = delete;
+
+        UpdateCombiner(UpdateCombiner &&) = delete;
+
+        UpdateCombiner &operator=(const UpdateCombiner &) = delete;
+
+        UpdateCombiner &operator=(UpdateCombiner &&) = delete;
+
+        // fn(TValue &) modifies a copy of the current value, throws std::logic_error if the target is empty
+        template <class Fn>
+        void update(Fn &&fn) {
+            Request request;
+            request.apply = [](void *fn, TValue &value) {
+                (*static_cast<std::remove_reference_t<Fn> *>(fn))(value);
+            };
+            request.fn = const_cast<void *>(static_cast<const void *>(std::addressof(fn)));
+            Request *head = pending_.load(std::memory_order_relaxed);
+            do {
+                request.next = head;
+            } while (!pending_.compare_exchange_weak(head, &request, std::memory_order_release,
+                                                     std::memory_order_relaxed));
+            Backoff backoff;
+            while (!request.done.load(std::memory_order_acquire)) {
+                if (!combining_.load(std::memory_order_relaxed) &&
+                    !combining_.exchange(true, std::memory_order_acquire)) {
+                    combine();
+                    combining_.store(false, std::memory_order_release);
+                } else {
+                    backoff.pause();
+                }
+            }
+            if (request.error) {
+                std::rethrow_exception(request.error);
+            }
+        }
+
+    private:
+        void combine() {
+            Request *batch = pending_.exchange(nullptr, std::memory_order_acquire);
+            Request *ordered = nullptr;
+            while (batch != nullptr) {
+                Request *next = batch->next;
+                batch->next = ordered;
+                ordered = batch;
+                batch = next;
+            }
+            if (ordered == nullptr) {
+                return;
+            }
+            Backoff backoff;
+            auto current = target_.snapshot();
+            while (true) {
+                if (!current) {
+                    // there is no value to copy, the whole batch fails
+                    failAll(ordered, std::make_exception_ptr(std::logic_error("Combined update of an empty target")));
+                    break;
+                }
+                SharedPtr<TValue> desired = makeShared<TValue>(*current);
+                if (!applyAll(ordered, *desired)) {
+                    continue;
+                }
+                if (target_.compareExchange(current, std::move(desired))) {
+                    break;
+                }
+                backoff.pause();
+            }
+            while (ordered != nullptr) {
+                // the request lives on the stack of its updater, which may return as soon as done is set
+                Request *next = ordered->next;
+                ordered->done.store(true, std::memory_order_release);
+                ordered = next;
+            }
+        }
+
+        // returns false if a mutator threw, the copy is then partially modified and has to be made again
+        static bool applyAll(Request *requests, TValue &value) {
+            for (Request *it = requests; it != nullptr; it = it->next) {
+                if (it->error) {
+                    continue;
+                }
+                try {
+                    it->apply(it->fn, value);
+                } catch (...) {
+                    it->error = std::current_exception();
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static void failAll(Request *requests, const std::exception_ptr &error) {
+            for (Request *it = requests; it != nullptr; it = it->next) {
+                if (!it->error) {
+                    it->error = error;
+                }
+            }
+        }
+
+    private:
+        Target &target_;
+        std::atomic<Request *> pending_{nullptr};
+        std::atomic<bool> combining_{false};
+    };
+}// namespace lu::detail
+
+#endif//ATOMIC_SHARED_POINTER_UPDATE_COMBINER_H
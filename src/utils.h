@@ -5,10 +5,95 @@
 #ifndef ATOMIC_SHARED_POINTER_UTILS_H
 #define ATOMIC_SHARED_POINTER_UTILS_H
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <thread>
 #include <utility>
 
+#if __has_include(<sys/single_threaded.h>)
+#include <sys/single_threaded.h>
+#endif
+
 namespace lu {
+    inline constexpr size_t kCacheLineSize = 64;
+
+    // true while the process has never started a second thread
+    inline bool isSingleThreaded() {
+#if __has_include(<sys/single_threaded.h>)
+        return __libc_single_threaded;
+#else
+        return false;
+#endif
+    }
+
+    // fetch_add that falls back to a plain load and store in a single threaded process
+    template <class TValue>
+    TValue fetchAdd(std::atomic<TValue> &value, TValue delta, std::memory_order order = std::memory_order_seq_cst) {
+        if (isSingleThreaded()) {
+            TValue old = value.load(std::memory_order_relaxed);
+            value.store(old + delta, std::memory_order_relaxed);
+            return old;
+        }
+        return value.fetch_add(delta, order);
+    }
+
+    // the strongest failure order a compare exchange with the given success order may use
+    constexpr std::memory_order failureOrder(std::memory_order order) {
+        switch (order) {
+            case std::memory_order_acq_rel:
+                return std::memory_order_acquire;
+            case std::memory_order_release:
+                return std::memory_order_relaxed;
+            default:
+                return order;
+        }
+    }
+
+    // a loaded pointer is dereferenced right away, so weaker orders than acquire are raised to it
+    constexpr std::memory_order dereferenceOrder(std::memory_order order) {
+        return order == std::memory_order_seq_cst ? order : std::memory_order_acquire;
+    }
+
+    // a replaced word hands its references over to the replacer, so the read of it acquires at least
+    constexpr std::memory_order replaceOrder(std::memory_order order) {
+        return order == std::memory_order_seq_cst ? order : std::memory_order_acq_rel;
+    }
+
+    inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    // exponential backoff for contended retry loops, spins twice as long after every failure and yields once
+    // the spin limit is reached
+    class Backoff {
+        static constexpr uint32_t kMaxSpins = 1024;
+
+    public:
+        void pause() {
+            if (spins_ > kMaxSpins) {
+                std::this_thread::yield();
+                return;
+            }
+            for (uint32_t i = 0; i < spins_; ++i) {
+                cpuRelax();
+            }
+            spins_ *= 2;
+        }
+
+        void reset() {
+            spins_ = 1;
+        }
+
+    private:
+        uint32_t spins_{1};
+    };
+
     template <class TValue>
     class AlignedStorage {
     public:
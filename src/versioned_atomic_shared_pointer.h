@@ -0,0 +1,107 @@
+//
+// Created by ludaludaed on 18.10.2026.
+//
+
+#ifndef ATOMIC_SHARED_POINTER_VERSIONED_ATOMIC_SHARED_POINTER_H
+#define ATOMIC_SHARED_POINTER_VERSIONED_ATOMIC_SHARED_POINTER_H
+
+#include "atomic_shared_pointer.h"
+#include "split_ref_count.h"
+#include <atomic>
+#include <cstdint>
+
+namespace lu::detail {
+    // AtomicSharedPtr with a generation counter that every successful store, exchange and compare exchange bumps
+    // after replacing the pointer. Pollers compare generations instead of pointers, which are unreliable since a
+    // freed control block may be reused at the same address, and an unchanged slot costs a single load.
+    // A value loaded after reading a generation is at least as new as that generation, so a change may be
+    // reported twice but is never missed.
+    template <class TValue, class Reclaimer>
+    class VersionedAtomicSharedPtr {
+    public:
+        // older than every generation, loadIfChanged() with it always loads
+        static constexpr uint64_t kNoVersion = 0;
+
+        static constexpr bool is_always_lock_free = true;
+
+    public:
+        VersionedAtomicSharedPtr() = default;
+
+        VersionedAtomicSharedPtr(const VersionedAtomicSharedPtr &) = delete;
+
+        VersionedAtomicSharedPtr(VersionedAtomicSharedPtr &&) = delete;
+
+        VersionedAtomicSharedPtr &operator=(const VersionedAtomicSharedPtr &) = delete;
+
+        VersionedAtomicSharedPtr &operator=(VersionedAtomicSharedPtr &&) = delete;
+
+        VersionedAtomicSharedPtr &operator=(SharedPtr<TValue> other) {
+            store(std::move(other));
+            return *this;
+        }
+
+        [[nodiscard]] bool is_lock_free() const noexcept {
+            return true;
+        }
+
+        uint64_t version() const {
+            return version_.load(std::memory_order_acquire);
+        }
+
+        void store(SharedPtr<TValue> ptr, std::memory_order order = std::memory_order_seq_cst) {
+            ptr_.store(std::move(ptr), order);
+            bump();
+        }
+
+        SharedPtr<TValue> load(std::memory_order order = std::memory_order_seq_cst) const {
+            return ptr_.load(order);
+        }
+
+        // loads the value only if the generation differs from last_version, which is then updated
+        bool loadIfChanged(uint64_t &last_version, SharedPtr<TValue> &result,
+                           std::memory_order order = std::memory_order_seq_cst) const {
+            uint64_t current = version();
+            if (current == last_version) {
+                return false;
+            }
+            result = ptr_.load(order);
+            last_version = current;
+            return true;
+        }
+
+        SharedPtr<TValue> exchange(SharedPtr<TValue> ptr, std::memory_order order = std::memory_order_seq_cst) {
+            SharedPtr<TValue> result = ptr_.exchange(std::move(ptr), order);
+            bump();
+            return result;
+        }
+
+        bool compareExchange(SharedPtr<TValue> &expected, SharedPtr<TValue> desired,
+                             std::memory_order order = std::memory_order_seq_cst) {
+            if (ptr_.compareExchangeStrong(expected, std::move(desired), order)) {
+                bump();
+                return true;
+            }
+            return false;
+        }
+
+        bool compareExchangeWeak(SharedPtr<TValue> &expected, SharedPtr<TValue> desired,
+                                 std::memory_order order = std::memory_order_seq_cst) {
+            if (ptr_.compareExchangeWeak(expected, std::move(desired), order)) {
+                bump();
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        void bump() {
+            version_.fetch_add(1, std::memory_order_release);
+        }
+
+    private:
+        AtomicSharedPtr<TValue, Reclaimer> ptr_;
+        std::atomic<uint64_t> version_{kNoVersion + 1};
+    };
+}// namespace lu::detail
+
+#endif//ATOMIC_SHARED_POINTER_VERSIONED_ATOMIC_SHARED_POINTER_H
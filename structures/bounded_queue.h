@@ -0,0 +1,144 @@
+//
+// Created by ludaludaed on 18.10.2026.
+//
+
+#ifndef ATOMIC_SHARED_POINTER_BOUNDED_QUEUE_H
+#define ATOMIC_SHARED_POINTER_BOUNDED_QUEUE_H
+
+#include "../src/decl_fwd.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace lu {
+    // Bounded MPMC queue over a ring of sequence numbered cells in Vyukov's style. A cell whose sequence equals
+    // a producer position is free for that lap, and one whose sequence is the position plus one holds a value.
+    // Claiming a position is a CAS on the producer or consumer index, the value is published by storing the next
+    // sequence, so an element costs no allocation and no reference count. Capacity is rounded up to a power of two.
+    template <class TValue>
+    class BoundedQueue {
+        static constexpr size_t kDefaultCapacity = 1024;
+
+        struct alignas(kCacheLineSize) Cell {
+            std::atomic<size_t> sequence{0};
+            TValue value{};
+        };
+
+    public:
+        explicit BoundedQueue(size_t capacity = kDefaultCapacity)
+            : mask_(roundUp(capacity) - 1), cells_(std::make_unique<Cell[]>(mask_ + 1)) {
+            for (size_t i = 0; i <= mask_; ++i) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        BoundedQueue(const BoundedQueue &) = delete;
+
+        BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+        size_t capacity() const {
+            return mask_ + 1;
+        }
+
+        // returns false if the queue is full
+        bool tryPush(const TValue &value) {
+            return tryPushBatch(&value, 1) == 1;
+        }
+
+        // returns nullopt if the queue is empty
+        std::optional<TValue> tryPop() {
+            TValue value;
+            if (tryPopBatch(&value, 1) == 0) {
+                return std::nullopt;
+            }
+            return {std::move(value)};
+        }
+
+        // pushes a prefix of values with a single claim, returns its length
+        size_t tryPushBatch(const TValue *values, size_t count) {
+            if (count == 0) {
+                return 0;
+            }
+            size_t position = enqueue_position_.load(std::memory_order_relaxed);
+            while (true) {
+                size_t ready = readyPrefix(position, count, 0);
+                if (ready == 0) {
+                    if (cellLag(position, 0) < 0) {
+                        return 0;
+                    }
+                    // the cell was released after the position was read
+                    position = enqueue_position_.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (enqueue_position_.compare_exchange_weak(position, position + ready, std::memory_order_relaxed)) {
+                    for (size_t i = 0; i < ready; ++i) {
+                        Cell &cell = cells_[(position + i) & mask_];
+                        cell.value = values[i];
+                        cell.sequence.store(position + i + 1, std::memory_order_release);
+                    }
+                    return ready;
+                }
+            }
+        }
+
+        // pops up to count values into out with a single claim, returns how many were popped
+        size_t tryPopBatch(TValue *out, size_t count) {
+            if (count == 0) {
+                return 0;
+            }
+            size_t position = dequeue_position_.load(std::memory_order_relaxed);
+            while (true) {
+                size_t ready = readyPrefix(position, count, 1);
+                if (ready == 0) {
+                    if (cellLag(position, 1) < 0) {
+                        return 0;
+                    }
+                    position = dequeue_position_.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (dequeue_position_.compare_exchange_weak(position, position + ready, std::memory_order_relaxed)) {
+                    for (size_t i = 0; i < ready; ++i) {
+                        Cell &cell = cells_[(position + i) & mask_];
+                        out[i] = std::move(cell.value);
+                        cell.sequence.store(position + i + mask_ + 1, std::memory_order_release);
+                    }
+                    return ready;
+                }
+            }
+        }
+
+    private:
+        static size_t roundUp(size_t capacity) {
+            size_t result = 1;
+            while (result < capacity) {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        // negative if the cell at position is still a lap behind, zero if it is ready
+        intptr_t cellLag(size_t position, size_t offset) const {
+            size_t sequence = cells_[position & mask_].sequence.load(std::memory_order_acquire);
+            return static_cast<intptr_t>(sequence - (position + offset));
+        }
+
+        // the cells of a prefix cannot change until the index moves past them, so checking them one by one
+        // before the claim is enough
+        size_t readyPrefix(size_t position, size_t count, size_t offset) const {
+            size_t ready = 0;
+            while (ready < count && ready <= mask_ && cellLag(position + ready, offset) == 0) {
+                ++ready;
+            }
+            return ready;
+        }
+
+    private:
+        const size_t mask_;
+        std::unique_ptr<Cell[]> cells_;
+        alignas(kCacheLineSize) std::atomic<size_t> enqueue_position_{0};
+        alignas(kCacheLineSize) std::atomic<size_t> dequeue_position_{0};
+    };
+}// namespace lu
+
+#endif//ATOMIC_SHARED_POINTER_BOUNDED_QUEUE_H
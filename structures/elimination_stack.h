@@ -0,0 +1,127 @@
+//
+// Created by ludaludaed on 18.10.2026.
+//
+
+#ifndef ATOMIC_SHARED_POINTER_ELIMINATION_STACK_H
+#define ATOMIC_SHARED_POINTER_ELIMINATION_STACK_H
+
+#include "../src/decl_fwd.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+namespace lu {
+    // Treiber stack with an elimination array. A push that loses the race for head_ parks its node in a random
+    // slot of the arena for a short while, a pop that loses the race takes a parked node out of a slot, and the
+    // pair completes without touching head_. The arena width grows when slots are found busy or taken away and
+    // shrinks when a parked node is not picked up, so under low contention the operations stay on head_.
+    template <class TValue, class Reclaimer = HazardPointers<HPolicy<>>, class Allocator = std::allocator<TValue>>
+    class EliminationStack {
+    public:
+        struct Node {
+            TValue value;
+            SharedPtr<Node> next{};
+
+            template <class... Args>
+            Node(Args &&...args) : value(std::forward<Args>(args)...) {}
+        };
+
+    private:
+        static constexpr uint32_t kMaxWidth = 16;
+        static constexpr int kParkSpins = 128;
+
+        struct alignas(kCacheLineSize) Slot {
+            AtomicSharedPtr<Node, Reclaimer> offer;
+        };
+
+    public:
+        void push(const TValue &value) {
+            SharedPtr<Node> new_node = allocateShared<Node>(allocator_, value);
+            new_node->next = head_.load();
+            while (!head_.compareExchange(new_node->next, new_node)) {
+                if (eliminatePush(new_node)) {
+                    return;
+                }
+            }
+        }
+
+        std::optional<TValue> pop() {
+            auto head = head_.snapshot();
+            while (head && !head_.compareExchange(head, head.get()->next)) {
+                std::optional<TValue> eliminated = eliminatePop();
+                if (eliminated) {
+                    return eliminated;
+                }
+            }
+            if (!head) {
+                return std::nullopt;
+            }
+            return {head.get()->value};
+        }
+
+    private:
+        // returns true if a pop took the node
+        bool eliminatePush(const SharedPtr<Node> &node) {
+            Slot &slot = randomSlot();
+            SharedPtr<Node> empty;
+            if (!slot.offer.compareExchange(empty, node)) {
+                grow();
+                return false;
+            }
+            for (int i = 0; i < kParkSpins; ++i) {
+                cpuRelax();
+            }
+            SharedPtr<Node> parked = node;
+            if (slot.offer.compareExchange(parked, SharedPtr<Node>{})) {
+                shrink();
+                return false;
+            }
+            return true;
+        }
+
+        std::optional<TValue> eliminatePop() {
+            Slot &slot = randomSlot();
+            auto offer = slot.offer.snapshot();
+            if (!offer) {
+                return std::nullopt;
+            }
+            if (!slot.offer.compareExchange(offer, SharedPtr<Node>{})) {
+                grow();
+                return std::nullopt;
+            }
+            return {offer.get()->value};
+        }
+
+        Slot &randomSlot() {
+            thread_local uint32_t state = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&state)) | 1;
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return arena_[state % width_.load(std::memory_order_relaxed)];
+        }
+
+        // the width is a hint, concurrent adjustments may get lost
+        void grow() {
+            uint32_t width = width_.load(std::memory_order_relaxed);
+            if (width < kMaxWidth) {
+                width_.store(width + 1, std::memory_order_relaxed);
+            }
+        }
+
+        void shrink() {
+            uint32_t width = width_.load(std::memory_order_relaxed);
+            if (width > 1) {
+                width_.store(width - 1, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        Allocator allocator_{};
+        AtomicSharedPtr<Node, Reclaimer> head_{};
+        std::atomic<uint32_t> width_{1};
+        std::array<Slot, kMaxWidth> arena_{};
+    };
+}// namespace lu
+
+#endif//ATOMIC_SHARED_POINTER_ELIMINATION_STACK_H
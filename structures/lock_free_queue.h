@@ -6,15 +6,16 @@
 #define ATOMIC_SHARED_POINTER_LOCK_FREE_QUEUE_H
 
 #include "../src/decl_fwd.h"
+#include <chrono>
 #include <optional>
 
 namespace lu {
-    template <class TValue>
+    template <class TValue, class Reclaimer = HazardPointers<HPolicy<>>, class Allocator = std::allocator<TValue>>
     class LockFreeQueue {
     public:
         struct Node {
             TValue value{};
-            AtomicSharedPtr<Node> next{};
+            AtomicSharedPtr<Node, Reclaimer> next{};
 
             template <class... Args>
             Node(Args &&...args) : value(std::forward<Args>(args)...) {}
@@ -22,13 +23,13 @@ namespace lu {
 
     public:
         LockFreeQueue() {
-            SharedPtr<Node> dummy = makeShared<Node>();
+            SharedPtr<Node> dummy = allocateShared<Node>(allocator_);
             head_.store(dummy);
             tail_.store(dummy);
         }
 
         void push(const TValue &value) {
-            SharedPtr<Node> new_node = makeShared<Node>(value);
+            SharedPtr<Node> new_node = allocateShared<Node>(allocator_, value);
             SharedPtr<Node> cur_tail;
             while (true) {
                 cur_tail = tail_.load();
@@ -42,6 +43,7 @@ namespace lu {
                 }
             }
             tail_.compareExchange(cur_tail, new_node);
+            not_empty_.notifyOne();
         }
 
         std::optional<TValue> pop() {
@@ -58,9 +60,38 @@ namespace lu {
             }
         }
 
+        // blocks while the queue is empty
+        TValue popWait() {
+            while (true) {
+                std::optional<TValue> value = pop();
+                if (value) {
+                    return std::move(*value);
+                }
+                not_empty_.waitUntil([this] { return !empty(); });
+            }
+        }
+
+        // returns nullopt if the queue stayed empty for the whole timeout
+        template <class Rep, class Period>
+        std::optional<TValue> popFor(const std::chrono::duration<Rep, Period> &timeout) {
+            auto deadline = detail::WaitClock::now() + std::chrono::ceil<detail::WaitClock::duration>(timeout);
+            while (true) {
+                std::optional<TValue> value = pop();
+                if (value || !not_empty_.waitUntil([this] { return !empty(); }, deadline)) {
+                    return value;
+                }
+            }
+        }
+
+        bool empty() const {
+            return head_.read([](const Node *head) { return !head->next.snapshot(); });
+        }
+
     private:
-        AtomicSharedPtr<Node> head_;
-        AtomicSharedPtr<Node> tail_;
+        Allocator allocator_{};
+        AtomicSharedPtr<Node, Reclaimer> head_;
+        AtomicSharedPtr<Node, Reclaimer> tail_;
+        detail::EventCount not_empty_;
     };
 }// namespace lu
 
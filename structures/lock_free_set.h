@@ -0,0 +1,107 @@
+//
+// Created by ludaludaed on 18.10.2026.
+//
+
+#ifndef ATOMIC_SHARED_POINTER_LOCK_FREE_SET_H
+#define ATOMIC_SHARED_POINTER_LOCK_FREE_SET_H
+
+#include "../src/decl_fwd.h"
+#include <utility>
+
+namespace lu {
+    // Harris style sorted list: erase marks the successor link of a node before unlinking it, so an insert behind
+    // a node that is being erased fails its CAS instead of getting lost. Traversals unlink marked nodes they pass.
+    template <class TValue, class Reclaimer = HazardPointers<HPolicy<>>, class Allocator = std::allocator<TValue>>
+    class LockFreeSet {
+    public:
+        struct Node {
+            TValue value{};
+            MarkableAtomicSharedPtr<Node, Reclaimer> next{};
+
+            template <class... Args>
+            Node(Args &&...args) : value(std::forward<Args>(args)...) {}
+        };
+
+        using Marked = typename MarkableAtomicSharedPtr<Node, Reclaimer>::Marked;
+
+    public:
+        LockFreeSet() : head_(allocateShared<Node>(allocator_)) {}
+
+        bool insert(const TValue &value) {
+            SharedPtr<Node> new_node;
+            while (true) {
+                auto [pred, cur] = find(value);
+                if (cur && !(value < cur->value)) {
+                    return false;
+                }
+                if (!new_node) {
+                    new_node = allocateShared<Node>(allocator_, value);
+                }
+                new_node->next.store(cur);
+                Marked expected{cur, false};
+                if (pred->next.compareExchange(expected, new_node, false)) {
+                    return true;
+                }
+            }
+        }
+
+        bool erase(const TValue &value) {
+            while (true) {
+                auto [pred, cur] = find(value);
+                if (!cur || value < cur->value) {
+                    return false;
+                }
+                Marked succ = cur->next.load();
+                if (succ.mark || !cur->next.tryMark(succ.ptr)) {
+                    continue;
+                }
+                // a failed unlink is left to the next traversal
+                Marked expected{cur, false};
+                pred->next.compareExchange(expected, std::move(succ.ptr), false);
+                return true;
+            }
+        }
+
+        bool contains(const TValue &value) const {
+            Marked cur = head_->next.load();
+            while (cur.ptr && cur.ptr->value < value) {
+                cur = cur.ptr->next.load();
+            }
+            return cur.ptr && !(value < cur.ptr->value) && !cur.ptr->next.isMarked();
+        }
+
+    private:
+        // the last unmarked node before value and the first node not less than value, null past the end
+        std::pair<SharedPtr<Node>, SharedPtr<Node>> find(const TValue &value) {
+        retry:
+            SharedPtr<Node> pred = head_;
+            Marked cur = pred->next.load();
+            while (cur.ptr) {
+                Marked succ = cur.ptr->next.load();
+                while (succ.mark) {
+                    Marked expected{cur.ptr, false};
+                    if (!pred->next.compareExchange(expected, succ.ptr, false)) {
+                        goto retry;
+                    }
+                    cur.ptr = std::move(succ.ptr);
+                    if (!cur.ptr) {
+                        return {std::move(pred), SharedPtr<Node>{}};
+                    }
+                    succ = cur.ptr->next.load();
+                }
+                if (!(cur.ptr->value < value)) {
+                    break;
+                }
+                pred = std::move(cur.ptr);
+                cur = std::move(succ);
+            }
+            return {std::move(pred), std::move(cur.ptr)};
+        }
+
+    private:
+        Allocator allocator_{};
+        SharedPtr<Node> head_;
+    };
+}// namespace lu
+
+#endif//ATOMIC_SHARED_POINTER_LOCK_FREE_SET_H
@@ -9,7 +9,7 @@
 #include <optional>
 
 namespace lu {
-    template <class TValue>
+    template <class TValue, class Reclaimer = HazardPointers<HPolicy<>>, class Allocator = std::allocator<TValue>>
     class LockFreeStack {
     public:
         struct Node {
@@ -22,25 +22,23 @@ namespace lu {
 
     public:
         void push(const TValue &value) {
-            SharedPtr<Node> new_node = makeShared<Node>(value);
-            do {
-                new_node->next = head_.load();
-            } while (!head_.compareExchange(new_node->next, new_node));
+            SharedPtr<Node> new_node = allocateShared<Node>(allocator_, value);
+            new_node->next = head_.load();
+            while (!head_.compareExchange(new_node->next, new_node)) {}
         }
 
         std::optional<TValue> pop() {
-            SharedPtr<Node> head;
-            do {
-                head = head_.load();
-                if (!head) {
-                    return std::nullopt;
-                }
-            } while (!head_.compareExchange(head, head->next));
-            return {head->value};
+            auto head = head_.snapshot();
+            while (head && !head_.compareExchange(head, head.get()->next)) {}
+            if (!head) {
+                return std::nullopt;
+            }
+            return {head.get()->value};
         }
 
     private:
-        AtomicSharedPtr<Node> head_{};
+        Allocator allocator_{};
+        AtomicSharedPtr<Node, Reclaimer> head_{};
     };
 }// namespace lu
 
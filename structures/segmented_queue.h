@@ -0,0 +1,117 @@
+//
+// Created by ludaludaed on 18.10.2026.
+//
+
+#ifndef ATOMIC_SHARED_POINTER_SEGMENTED_QUEUE_H
+#define ATOMIC_SHARED_POINTER_SEGMENTED_QUEUE_H
+
+#include "../src/decl_fwd.h"
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+namespace lu {
+    // Unbounded queue of fixed size segments in the style of the FAA array queue. Producers and consumers claim
+    // cells of the tail and head segments with fetch_add on separate indices, a cell is filled and taken with a
+    // single CAS on its state. A consumer that overtakes the producer of its cell poisons the cell, and the
+    // producer claims another one. Segments are the only allocations, one each with the inplace layout. They are
+    // linked through AtomicSharedPtr and freed once head_ and the previous segment drop them.
+    template <class TValue, class Reclaimer = HazardPointers<HPolicy<>>, class Allocator = std::allocator<TValue>>
+    class SegmentedQueue {
+        static constexpr size_t kSegmentSize = 1024;
+        static constexpr int kPatience = 64;
+
+        enum CellState : uint8_t {
+            kEmpty,
+            kFull,
+            kPoisoned
+        };
+
+    public:
+        struct Segment {
+            struct Cell {
+                std::atomic<CellState> state{kEmpty};
+                TValue value{};
+            };
+
+            alignas(kCacheLineSize) std::atomic<size_t> enqueue_index{0};
+            alignas(kCacheLineSize) std::atomic<size_t> dequeue_index{0};
+            AtomicSharedPtr<Segment, Reclaimer> next{};
+            Cell cells[kSegmentSize];
+        };
+
+    public:
+        SegmentedQueue() {
+            SharedPtr<Segment> first = allocateShared<Segment>(allocator_);
+            head_.store(first);
+            tail_.store(first);
+        }
+
+        void push(const TValue &value) {
+            while (true) {
+                auto tail = tail_.snapshot();
+                Segment *segment = tail.get();
+                size_t index = segment->enqueue_index.fetch_add(1);
+                if (index < kSegmentSize) {
+                    typename Segment::Cell &cell = segment->cells[index];
+                    cell.value = value;
+                    CellState expected = kEmpty;
+                    if (cell.state.compare_exchange_strong(expected, kFull, std::memory_order_release,
+                                                           std::memory_order_relaxed)) {
+                        return;
+                    }
+                    continue;
+                }
+                SharedPtr<Segment> next = segment->next.load();
+                if (!next) {
+                    // the value goes into the first cell of the new segment, so linking it completes the push
+                    SharedPtr<Segment> fresh = allocateShared<Segment>(allocator_);
+                    fresh->cells[0].value = value;
+                    fresh->cells[0].state.store(kFull, std::memory_order_relaxed);
+                    fresh->enqueue_index.store(1, std::memory_order_relaxed);
+                    if (segment->next.compareExchange(next, fresh)) {
+                        tail_.compareExchange(tail, std::move(fresh));
+                        return;
+                    }
+                }
+                tail_.compareExchange(tail, std::move(next));
+            }
+        }
+
+        std::optional<TValue> pop() {
+            while (true) {
+                auto head = head_.snapshot();
+                Segment *segment = head.get();
+                if (segment->dequeue_index.load() >= segment->enqueue_index.load() && !segment->next.snapshot()) {
+                    return std::nullopt;
+                }
+                size_t index = segment->dequeue_index.fetch_add(1);
+                if (index < kSegmentSize) {
+                    typename Segment::Cell &cell = segment->cells[index];
+                    // the producer of the cell has already claimed it, give it a moment before poisoning
+                    for (int i = 0; i < kPatience && cell.state.load(std::memory_order_relaxed) == kEmpty; ++i) {
+                        cpuRelax();
+                    }
+                    CellState state = kEmpty;
+                    if (cell.state.compare_exchange_strong(state, kPoisoned, std::memory_order_acq_rel,
+                                                           std::memory_order_acquire)) {
+                        continue;
+                    }
+                    return {std::move(cell.value)};
+                }
+                SharedPtr<Segment> next = segment->next.load();
+                if (!next) {
+                    return std::nullopt;
+                }
+                head_.compareExchange(head, std::move(next));
+            }
+        }
+
+    private:
+        Allocator allocator_{};
+        AtomicSharedPtr<Segment, Reclaimer> head_;
+        AtomicSharedPtr<Segment, Reclaimer> tail_;
+    };
+}// namespace lu
+
+#endif//ATOMIC_SHARED_POINTER_SEGMENTED_QUEUE_H